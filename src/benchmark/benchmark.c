@@ -0,0 +1,501 @@
+/**
+ *  \file benchmark.c (implementation file)
+ *
+ *  \brief Program that builds and benchmarks all the 'wordCount'
+ * implementations.
+ *
+ *  The program 'benchmark' compiles the single-threaded, multi-threaded (V1 and
+ * V2) and MPI versions of 'wordCount', runs each of them on every input file
+ * given, over a range of thread and rank counts, and repeats every run to keep
+ * the median of its wall-clock times. The medians are printed as a table and
+ * written to a CSV and a JSON file, along with the throughput, the speedup over
+ * the single-threaded version on the same input and the parallel efficiency.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/** \brief auxiliary variable for internal calculations. */
+#define BILLION 1000000000.0
+
+/** \brief largest size (number of bytes) of a command line. */
+#define MAXCOMMAND 4096
+
+/** \brief largest number of entries of a list of counts. */
+#define MAXCOUNTS 32
+
+/** \brief source files shared by the implementations (relative to 'src'). */
+#define COMMONFILES                                                          \
+    "common/charClass.c common/textScan.c common/histogram.c "               \
+    "common/inputMap.c common/affinity.c common/chunkPolicy.c "              \
+    "common/results.c common/resultWriter.c common/trace.c "                 \
+    "common/arena.c common/bufferPool.c"
+
+/**
+ *  \brief structure containing an implementation to benchmark.
+ */
+struct implementation {
+    /** \brief name of the implementation (and of its binary). */
+    const char* name;
+
+    /** \brief compiler and source files (relative to 'src'). */
+    const char* sources;
+
+    /** \brief libraries linked. */
+    const char* libraries;
+
+    /** \brief option setting the number of threads (NULL if none). */
+    const char* threadsOption;
+
+    /** \brief whether the binary is started by the MPI launcher. */
+    bool mpi;
+};
+
+/** \brief implementations benchmarked, the single-threaded one (the baseline of
+ * the speedups) first. */
+static const struct implementation implementations[] = {
+    {"wordCountST",
+     "gcc -Wall -O2 single-threaded/wordCount.c common/charClass.c "
+     "common/textScan.c common/histogram.c common/results.c "
+     "common/resultWriter.c",
+     "", NULL, false},
+    {"wordCountV1",
+     "gcc -Wall -O2 multi-threaded/wordCountV1.c multi-threaded/textProcV1.c "
+     "multi-threaded/chunkRing.c multi-threaded/workDeque.c "
+     "multi-threaded/workerStats.c " COMMONFILES,
+     "-lpthread", "-j", false},
+    {"wordCountV2",
+     "gcc -Wall -O2 multi-threaded/wordCountV2.c multi-threaded/textProcV2.c "
+     "multi-threaded/chunkRing.c multi-threaded/workDeque.c "
+     "multi-threaded/workerStats.c " COMMONFILES,
+     "-lpthread", "-j", false},
+    {"wordCountMPI",
+     "mpicc -Wall -O2 mpi/wordCount.c mpi/rankThreads.c " COMMONFILES,
+     "-lpthread", NULL, true},
+};
+
+/** \brief number of implementations. */
+#define NUMIMPLEMENTATIONS \
+    ((int)(sizeof(implementations) / sizeof(implementations[0])))
+
+/**
+ *  \brief structure containing the median times of a configuration.
+ */
+struct measure {
+    /** \brief wall-clock time (seconds) of the whole process. */
+    double wallTime;
+
+    /** \brief time (seconds) reported by the program (-1 if none). */
+    double reportedTime;
+};
+
+/** \brief directory holding the sources ('src'). */
+static const char* sourceDir = "..";
+
+/** \brief directory receiving the binaries (created if missing, and kept out
+ * of the sources). */
+static const char* buildDir = "../../build";
+
+/** \brief command starting an MPI program. */
+static const char* launcher = "mpiexec";
+
+/** \brief prefix of the output files. */
+static const char* outputPrefix = "benchmark";
+
+/** \brief number of runs of every configuration. */
+static int repeats = 5;
+
+/** \brief thread counts of the multi-threaded versions. */
+static int threadCounts[MAXCOUNTS] = {1, 2, 4, 8};
+
+/** \brief number of entries of 'threadCounts'. */
+static int numThreadCounts = 4;
+
+/** \brief rank counts of the MPI version. */
+static int rankCounts[MAXCOUNTS] = {2, 4};
+
+/** \brief number of entries of 'rankCounts'. */
+static int numRankCounts = 2;
+
+/** \brief whether each implementation was built. */
+static bool built[NUMIMPLEMENTATIONS];
+
+/** \brief CSV output file. */
+static FILE* csv;
+
+/** \brief JSON output file. */
+static FILE* json;
+
+/** \brief number of records written to the JSON file. */
+static int numRecords = 0;
+
+/**
+ *  \brief Parsing of a comma-separated list of positive counts.
+ *
+ *  \param list text of the list.
+ *  \param counts array receiving the counts.
+ *
+ *  \return number of counts (0 if the list is invalid).
+ */
+static int parseCounts(const char* list, int* counts) {
+    int numCounts = 0;
+    char* end;
+
+    while (*list != '\0' && numCounts < MAXCOUNTS) {
+        long count = strtol(list, &end, 10);
+        if (end == list || count <= 0 || (*end != ',' && *end != '\0')) {
+            return 0;
+        }
+        counts[numCounts++] = (int)count;
+        list = *end == ',' ? end + 1 : end;
+    }
+    return *list == '\0' ? numCounts : 0;
+}
+
+/**
+ *  \brief Compilation of an implementation.
+ *
+ *  \param impl implementation.
+ *
+ *  \return false if the compilation failed.
+ */
+static bool build(const struct implementation* impl) {
+    char command[MAXCOMMAND];
+
+    // Compile from the source directory, so that the source paths hold
+    snprintf(command, sizeof(command), "cd '%s' && %s -o '%s/%s' %s",
+             sourceDir, impl->sources, buildDir, impl->name, impl->libraries);
+    printf("Building %s...\n", impl->name);
+    fflush(stdout);
+    return system(command) == 0;
+}
+
+/**
+ *  \brief Comparison of two times, for sorting.
+ *
+ *  \param a first time.
+ *  \param b second time.
+ *
+ *  \return negative, zero or positive as 'a' is smaller, equal or larger.
+ */
+static int compareTimes(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ *  \brief Median of a set of times (the set is sorted).
+ *
+ *  \param times times.
+ *  \param numTimes number of times.
+ *
+ *  \return median.
+ */
+static double median(double* times, int numTimes) {
+    qsort(times, numTimes, sizeof(double), compareTimes);
+    return numTimes % 2 == 1
+               ? times[numTimes / 2]
+               : (times[numTimes / 2 - 1] + times[numTimes / 2]) / 2;
+}
+
+/**
+ *  \brief Repeated runs of a configuration.
+ *
+ *  \param impl implementation.
+ *  \param workers number of threads or ranks.
+ *  \param input path to the input file.
+ *  \param result median times.
+ *
+ *  \return false if a run failed.
+ */
+static bool run(const struct implementation* impl, int workers,
+                const char* input, struct measure* result) {
+    char command[MAXCOMMAND];
+    char line[256];
+    double wallTimes[repeats];
+    double reportedTimes[repeats];
+    struct timespec t0, t1;
+    FILE* output;
+
+    if (impl->mpi) {
+        snprintf(command, sizeof(command), "%s -n %d '%s/%s' '%s'", launcher,
+                 workers, buildDir, impl->name, input);
+    } else if (impl->threadsOption != NULL) {
+        snprintf(command, sizeof(command), "'%s/%s' %s %d '%s'", buildDir,
+                 impl->name, impl->threadsOption, workers, input);
+    } else {
+        snprintf(command, sizeof(command), "'%s/%s' '%s'", buildDir,
+                 impl->name, input);
+    }
+
+    for (int i = 0; i < repeats; i++) {
+        // Time the whole process, and keep the time it reports, if any
+        reportedTimes[i] = -1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        if ((output = popen(command, "r")) == NULL) {
+            return false;
+        }
+        while (fgets(line, sizeof(line), output) != NULL) {
+            sscanf(line, "Elapsed time = %lf s", &reportedTimes[i]);
+        }
+        if (pclose(output) != 0) {
+            return false;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        wallTimes[i] =
+            (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / BILLION;
+    }
+    result->wallTime = median(wallTimes, repeats);
+    result->reportedTime = median(reportedTimes, repeats);
+    return true;
+}
+
+/**
+ *  \brief Ratio of two measures, 0 if it is not a finite number (e.g. when
+ * dividing by 0), since JSON has no such numbers.
+ *
+ *  \param numerator numerator.
+ *  \param denominator denominator.
+ *
+ *  \return ratio.
+ */
+static double ratio(double numerator, double denominator) {
+    double value = numerator / denominator;
+
+    return isfinite(value) ? value : 0;
+}
+
+/**
+ *  \brief Writing of a path as a JSON string.
+ *
+ *  \param file file to write to.
+ *  \param text path to write.
+ *
+ */
+static void writeJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (; *text != '\0'; text++) {
+        unsigned char c = *text;
+        if (c == '"' || c == '\\') {
+            fprintf(file, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ *  \brief Writing of a path as a CSV field.
+ *
+ *  \param file file to write to.
+ *  \param text path to write.
+ *
+ */
+static void writeCsvString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (; *text != '\0'; text++) {
+        if (*text == '"') {
+            fputc('"', file);
+        }
+        fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+/**
+ *  \brief Presentation and saving of the measures of a configuration.
+ *
+ *  \param impl implementation.
+ *  \param workers number of threads or ranks.
+ *  \param input path to the input file.
+ *  \param inputSize size (number of bytes) of the input file.
+ *  \param result median times.
+ *  \param baseline median wall-clock time of the single-threaded version.
+ *
+ */
+static void record(const struct implementation* impl, int workers,
+                   const char* input, size_t inputSize,
+                   const struct measure* result, double baseline) {
+    double throughput = ratio(inputSize / 1e6, result->wallTime);
+    double speedup = ratio(baseline, result->wallTime);
+    double efficiency = ratio(speedup, workers);
+
+    printf("%-14s %7d %12zu %11.6f %11.6f %10.2f %8.2f %10.2f  %s\n",
+           impl->name, workers, inputSize, result->wallTime,
+           result->reportedTime, throughput, speedup, efficiency, input);
+
+    fprintf(csv, "%s,%d,", impl->name, workers);
+    writeCsvString(csv, input);
+    fprintf(csv, ",%zu,%d,%.6f,%.6f,%.2f,%.3f,%.3f\n", inputSize, repeats,
+            result->wallTime, result->reportedTime, throughput, speedup,
+            efficiency);
+
+    fprintf(json,
+            "%s\n  {\"implementation\": \"%s\", \"workers\": %d, "
+            "\"input\": ",
+            numRecords > 0 ? "," : "", impl->name, workers);
+    writeJsonString(json, input);
+    fprintf(json,
+            ", \"bytes\": %zu, \"repeats\": %d, \"median_s\": %.6f, "
+            "\"reported_s\": %.6f, \"mb_per_s\": %.2f, \"speedup\": %.3f, "
+            "\"efficiency\": %.3f}",
+            inputSize, repeats, result->wallTime, result->reportedTime,
+            throughput, speedup, efficiency);
+    numRecords++;
+}
+
+/**
+ *  \brief Benchmark of all the implementations on an input file.
+ *
+ *  \param input path to the input file.
+ *
+ */
+static void benchmark(const char* input) {
+    static const int once[] = {1};
+    struct measure result;
+    struct stat info;
+    double baseline = 0;
+
+    if (stat(input, &info) != 0) {
+        printf("Error while opening file %s!\n", input);
+        return;
+    }
+
+    for (int i = 0; i < NUMIMPLEMENTATIONS; i++) {
+        const struct implementation* impl = &implementations[i];
+        const int* counts = impl->mpi ? rankCounts : threadCounts;
+        int numCounts = impl->mpi ? numRankCounts : numThreadCounts;
+
+        if (!built[i]) {
+            continue;
+        }
+        // The single-threaded version runs once per input
+        if (impl->threadsOption == NULL && !impl->mpi) {
+            counts = once;
+            numCounts = 1;
+        }
+        for (int j = 0; j < numCounts; j++) {
+            if (!run(impl, counts[j], input, &result)) {
+                printf("Error while running %s on %s!\n", impl->name, input);
+                continue;
+            }
+            if (i == 0) {
+                baseline = result.wallTime;
+            }
+            record(impl, counts[j], input, info.st_size, &result, baseline);
+        }
+        fflush(stdout);
+    }
+}
+
+/**
+ *  \brief Main function called when the program is executed.
+ *
+ *  \param argc number of arguments passed to the program.
+ *  \param argv options followed by the paths to the input files: number of runs
+ * of every configuration ('-r RUNS', 5 by default), thread counts ('-j LIST',
+ * 1,2,4,8 by default), rank counts ('-n LIST', 2,4 by default), MPI launcher
+ * ('-l COMMAND', mpiexec by default), source directory ('-s DIR', .. by
+ * default), build directory ('-b DIR', ../../build by default, outside the
+ * sources) and prefix of the output files ('-o PREFIX', benchmark by default).
+ *
+ */
+int main(int argc, char** argv) {
+    char path[MAXCOMMAND];
+    int opt;
+
+    // Validate program arguments
+    while ((opt = getopt(argc, argv, "r:j:n:l:s:b:o:")) != -1) {
+        switch (opt) {
+            case 'r':
+                repeats = atoi(optarg);
+                break;
+            case 'j':
+                numThreadCounts = parseCounts(optarg, threadCounts);
+                break;
+            case 'n':
+                numRankCounts = parseCounts(optarg, rankCounts);
+                break;
+            case 'l':
+                launcher = optarg;
+                break;
+            case 's':
+                sourceDir = optarg;
+                break;
+            case 'b':
+                buildDir = optarg;
+                break;
+            case 'o':
+                outputPrefix = optarg;
+                break;
+            default:
+                repeats = 0;
+        }
+    }
+    if (repeats <= 0 || numThreadCounts == 0 || numRankCounts == 0 ||
+        optind >= argc) {
+        printf("Usage: %s [-r RUNS] [-j LIST] [-n LIST] [-l COMMAND] "
+               "[-s DIR] [-b DIR] [-o PREFIX] file...\n",
+               argv[0]);
+        exit(1);
+    }
+    if ((mkdir(buildDir, 0755) != 0 && errno != EEXIST) ||
+        realpath(buildDir, path) == NULL || (buildDir = strdup(path)) == NULL) {
+        printf("Error while opening directory %s!\n", buildDir);
+        exit(1);
+    }
+
+    // Build every implementation (the MPI one may be missing)
+    for (int i = 0; i < NUMIMPLEMENTATIONS; i++) {
+        built[i] = build(&implementations[i]);
+        if (!built[i] && !implementations[i].mpi) {
+            printf("Error while building %s!\n", implementations[i].name);
+            exit(1);
+        }
+        if (!built[i]) {
+            printf("Skipping %s.\n", implementations[i].name);
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s.csv", outputPrefix);
+    if ((csv = fopen(path, "w")) == NULL) {
+        printf("Error while creating file %s!\n", path);
+        exit(1);
+    }
+    snprintf(path, sizeof(path), "%s.json", outputPrefix);
+    if ((json = fopen(path, "w")) == NULL) {
+        printf("Error while creating file %s!\n", path);
+        exit(1);
+    }
+    fprintf(csv, "implementation,workers,input,bytes,repeats,median_s,"
+                 "reported_s,mb_per_s,speedup,efficiency\n");
+    fprintf(json, "[");
+
+    printf("\n%-14s %7s %12s %11s %11s %10s %8s %10s  %s\n", "Implementation",
+           "Workers", "Bytes", "Median (s)", "Reported", "MB/s", "Speedup",
+           "Efficiency", "Input");
+    for (int i = optind; i < argc; i++) {
+        benchmark(argv[i]);
+    }
+
+    fprintf(json, "\n]\n");
+    fclose(csv);
+    fclose(json);
+    free((char*)buildDir);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,429 @@
+/**
+ *  \file generator.c (implementation file)
+ *
+ *  \brief Program that writes synthetic texts for the 'wordCount' programs.
+ *
+ *  The program 'generator' writes a UTF-8 text of a given size made of random
+ * words. The word sizes follow a (shifted) Poisson distribution of tunable
+ * mean, the letters are vowels with a tunable probability, a tunable share of
+ * the characters are multi-byte ones, some words are joined by mergers and a
+ * tunable share of the words are very long ones. The characters are taken from
+ * the lists of delimiters, mergers and vowels the programs classify text with;
+ * a tunable share of them may be replaced by malformed UTF-8, whose counts must
+ * not depend on where the programs cut the text.
+ * The text only depends on the options, so a seed reproduces it exactly.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../common/charClass.h"
+#include "../common/chunkPolicy.h"
+
+/** \brief largest code point looked up in the character class table. */
+#define MAXCODEPOINT 0x3000
+
+/** \brief largest number of characters of a pool. */
+#define MAXPOOLSIZE 64
+
+/** \brief size (number of bytes) of the output buffer. */
+#define OUTPUTSIZE (1024 * 1024)
+
+/** \brief consonants written (the ones outside ASCII are multi-byte). */
+static const unsigned int consonants[] = {
+    'b',  'c',  'd',  'f',  'g',  'h',  'j',  'k',  'l',  'm',  'n',
+    'p',  'q',  'r',  's',  't',  'v',  'w',  'x',  'y',  'z',  'B',
+    'C',  'D',  'F',  'G',  'L',  'M',  'N',  'P',  'R',  'S',  'T',
+    0xE7, 0xC7, 0xF1, 0xD1, 0xDF};
+
+/** \brief malformed UTF-8 sequences (a byte that cannot start a sequence, a
+ * stray continuation byte, sequences cut short, overlong or out of range). */
+static const char* malformed[] = {"\xFF",         "\xFE",     "\x80",
+                                  "\xC3",         "\xE2\x80", "\xC0\xAF",
+                                  "\xE0\x80\xA0", "\xF4\x90\x80\x80",
+                                  "\xF8\x88\x80\x80\x80"};
+
+/**
+ *  \brief structure containing the characters of a class, split by length.
+ */
+struct charPool {
+    /** \brief UTF-8 encoded single-byte characters. */
+    char single[MAXPOOLSIZE][4];
+
+    /** \brief number of entries of 'single'. */
+    int numSingle;
+
+    /** \brief UTF-8 encoded multi-byte characters (null-terminated). */
+    char multi[MAXPOOLSIZE][5];
+
+    /** \brief number of entries of 'multi'. */
+    int numMulti;
+};
+
+/** \brief pools of vowels, consonants, mergers and punctuation delimiters. */
+static struct charPool vowelPool, consonantPool, mergerPool, punctuationPool;
+
+/** \brief state of the random number generator. */
+static uint64_t randomState;
+
+/** \brief size (number of bytes) of the text. */
+static size_t textSize = 1024 * 1024;
+
+/** \brief mean word size (number of characters). */
+static double meanWordSize = 5;
+
+/** \brief largest size of an ordinary word. */
+static int maxWordSize = 20;
+
+/** \brief probability of a letter being a vowel. */
+static double vowelShare = 0.4;
+
+/** \brief probability of a character being a multi-byte one. */
+static double multiByteShare = 0.05;
+
+/** \brief probability of a word holding a merger. */
+static double mergerShare = 0.02;
+
+/** \brief probability of a delimiter being a punctuation mark. */
+static double punctuationShare = 0.1;
+
+/** \brief probability of a word being a very long one. */
+static double longWordShare = 0;
+
+/** \brief size of the very long words. */
+static int longWordSize = 10000;
+
+/** \brief probability of a character being replaced by malformed UTF-8. */
+static double malformedShare = 0;
+
+/** \brief output buffer. */
+static char output[OUTPUTSIZE];
+
+/** \brief number of bytes stored in 'output'. */
+static size_t outputSize = 0;
+
+/** \brief number of bytes written. */
+static size_t written = 0;
+
+/** \brief file the text is written to. */
+static FILE* outputFile;
+
+/**
+ *  \brief Next random number (splitmix64, so the text is the same everywhere).
+ *
+ *  \return random 64-bit number.
+ */
+static uint64_t nextRandom(void) {
+    uint64_t z = (randomState += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ *  \brief Random number in [0, 1).
+ *
+ *  \return random number.
+ */
+static double randomUnit(void) {
+    return (nextRandom() >> 11) * 0x1.0p-53;
+}
+
+/**
+ *  \brief Random number of a Poisson distribution.
+ *
+ *  \param mean mean of the distribution.
+ *
+ *  \return random number.
+ */
+static int randomPoisson(double mean) {
+    double limit = exp(-mean);
+    double product = randomUnit();
+    int count = 0;
+
+    while (product > limit) {
+        product *= randomUnit();
+        count++;
+    }
+    return count;
+}
+
+/**
+ *  \brief UTF-8 encoding of a code point.
+ *
+ *  \param codePoint code point.
+ *  \param text buffer receiving the null-terminated encoding.
+ *
+ *  \return number of bytes of the encoding.
+ */
+static int encodeChar(unsigned int codePoint, char* text) {
+    int len;
+
+    if (codePoint < 0x80) {
+        text[0] = codePoint;
+        len = 1;
+    } else if (codePoint < 0x800) {
+        text[0] = 0xC0 | (codePoint >> 6);
+        text[1] = 0x80 | (codePoint & 0x3F);
+        len = 2;
+    } else {
+        text[0] = 0xE0 | (codePoint >> 12);
+        text[1] = 0x80 | ((codePoint >> 6) & 0x3F);
+        text[2] = 0x80 | (codePoint & 0x3F);
+        len = 3;
+    }
+    text[len] = '\0';
+    return len;
+}
+
+/**
+ *  \brief Addition of a character to a pool.
+ *
+ *  \param pool pool to update.
+ *  \param codePoint code point of the character.
+ *
+ */
+static void addToPool(struct charPool* pool, unsigned int codePoint) {
+    char text[5];
+
+    if (encodeChar(codePoint, text) == 1) {
+        if (pool->numSingle < MAXPOOLSIZE) {
+            strcpy(pool->single[pool->numSingle++], text);
+        }
+    } else if (pool->numMulti < MAXPOOLSIZE) {
+        strcpy(pool->multi[pool->numMulti++], text);
+    }
+}
+
+/**
+ *  \brief Construction of the pools from the character class table.
+ *
+ */
+static void buildPools(void) {
+    initCharClasses();
+    for (unsigned int cp = 0x21; cp < MAXCODEPOINT; cp++) {
+        int charClass = codePointClass(cp);
+        if (charClass & CC_VOWEL) {
+            addToPool(&vowelPool, cp);
+        } else if (charClass & CC_MERGER) {
+            addToPool(&mergerPool, cp);
+        } else if (charClass & CC_DELIMITER) {
+            addToPool(&punctuationPool, cp);
+        }
+    }
+    for (size_t i = 0; i < sizeof(consonants) / sizeof(consonants[0]); i++) {
+        if (codePointClass(consonants[i]) == CC_LETTER) {
+            addToPool(&consonantPool, consonants[i]);
+        }
+    }
+}
+
+/**
+ *  \brief Writing of text to the output buffer.
+ *
+ *  \param text text.
+ *  \param len number of bytes of 'text'.
+ *
+ */
+static void emit(const char* text, size_t len) {
+    if (outputSize + len > OUTPUTSIZE) {
+        if (fwrite(output, 1, outputSize, outputFile) != outputSize) {
+            perror("Error while writing the text.\n");
+            exit(1);
+        }
+        outputSize = 0;
+    }
+    memcpy(output + outputSize, text, len);
+    outputSize += len;
+    written += len;
+}
+
+/**
+ *  \brief Writing of a random character of a pool.
+ *
+ *  \param pool pool.
+ *
+ */
+static void emitFromPool(const struct charPool* pool) {
+    const char* text;
+
+    // (no number is drawn unless asked, so the seeds keep their texts)
+    if (malformedShare > 0 && randomUnit() < malformedShare) {
+        text = malformed[nextRandom() %
+                         (sizeof(malformed) / sizeof(malformed[0]))];
+    } else if (pool->numMulti > 0 &&
+        (pool->numSingle == 0 || randomUnit() < multiByteShare)) {
+        text = pool->multi[nextRandom() % pool->numMulti];
+    } else {
+        text = pool->single[nextRandom() % pool->numSingle];
+    }
+    emit(text, strlen(text));
+}
+
+/**
+ *  \brief Writing of a random word.
+ *
+ */
+static void emitWord(void) {
+    int size = 1 + randomPoisson(meanWordSize - 1);
+    int merger = -1;
+
+    if (randomUnit() < longWordShare) {
+        size = longWordSize;
+    } else if (size > maxWordSize) {
+        size = maxWordSize;
+    }
+    // A merger sits between two letters, and does not count towards the size
+    if (size > 1 && randomUnit() < mergerShare) {
+        merger = 1 + nextRandom() % (size - 1);
+    }
+    for (int i = 0; i < size; i++) {
+        if (i == merger) {
+            emitFromPool(&mergerPool);
+        }
+        emitFromPool(randomUnit() < vowelShare ? &vowelPool : &consonantPool);
+    }
+}
+
+/**
+ *  \brief Writing of a random delimiter between two words.
+ *
+ */
+static void emitDelimiter(void) {
+    double draw = randomUnit();
+
+    if (draw < punctuationShare) {
+        emitFromPool(&punctuationPool);
+        emit(" ", 1);
+    } else if (draw < punctuationShare + 0.08) {
+        emit("\n", 1);
+    } else {
+        emit(" ", 1);
+    }
+}
+
+/**
+ *  \brief Parsing of a probability given on the command line.
+ *
+ *  \param arg argument to parse.
+ *  \param share probability parsed.
+ *
+ *  \return false if the argument is not a number between 0 and 1.
+ */
+static bool parseShare(const char* arg, double* share) {
+    char* end;
+    double value = strtod(arg, &end);
+
+    if (end == arg || *end != '\0' || value < 0 || value > 1) {
+        return false;
+    }
+    *share = value;
+    return true;
+}
+
+/**
+ *  \brief Main function called when the program is executed.
+ *
+ *  \param argc number of arguments passed to the program.
+ *  \param argv options: size of the text ('-s SIZE', with an optional K, M or G
+ * suffix, 1M by default), seed ('-S SEED', 1 by default), mean word size ('-l
+ * MEAN', 5 by default), largest ordinary word size ('-L MAX', 20 by default),
+ * probability of a vowel ('-v SHARE', 0.4 by default), of a multi-byte
+ * character ('-m SHARE', 0.05 by default), of a merger in a word ('-g SHARE',
+ * 0.02 by default), of a punctuation delimiter ('-p SHARE', 0.1 by default), of
+ * a very long word ('-x SHARE', 0 by default), size of the very long words ('-X
+ * SIZE', 10000 by default), probability of a character being malformed UTF-8
+ * ('-e SHARE', 0 by default) and path to the output file ('-o FILE', the
+ * standard output by default).
+ *
+ */
+int main(int argc, char** argv) {
+    unsigned long long seed = 1;
+    const char* path = NULL;
+    bool valid = true;
+    int opt;
+
+    // Validate program arguments
+    while ((opt = getopt(argc, argv, "s:S:l:L:v:m:g:p:x:X:e:o:")) != -1) {
+        switch (opt) {
+            case 's':
+                valid = valid && parseChunkSize(optarg, &textSize);
+                break;
+            case 'S':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'l':
+                meanWordSize = atof(optarg);
+                valid = valid && meanWordSize >= 1 && meanWordSize <= 30;
+                break;
+            case 'L':
+                maxWordSize = atoi(optarg);
+                valid = valid && maxWordSize >= 1;
+                break;
+            case 'v':
+                valid = valid && parseShare(optarg, &vowelShare);
+                break;
+            case 'm':
+                valid = valid && parseShare(optarg, &multiByteShare);
+                break;
+            case 'g':
+                valid = valid && parseShare(optarg, &mergerShare);
+                break;
+            case 'p':
+                valid = valid && parseShare(optarg, &punctuationShare) &&
+                        punctuationShare <= 0.9;
+                break;
+            case 'x':
+                valid = valid && parseShare(optarg, &longWordShare);
+                break;
+            case 'X':
+                longWordSize = atoi(optarg);
+                valid = valid && longWordSize >= 1;
+                break;
+            case 'e':
+                valid = valid && parseShare(optarg, &malformedShare);
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            default:
+                valid = false;
+        }
+    }
+    if (!valid || optind != argc) {
+        printf("Usage: %s [-s SIZE] [-S SEED] [-l MEAN] [-L MAX] [-v SHARE] "
+               "[-m SHARE] [-g SHARE] [-p SHARE] [-x SHARE] [-X SIZE] "
+               "[-e SHARE] [-o FILE]\n",
+               argv[0]);
+        exit(1);
+    }
+    if (path == NULL) {
+        outputFile = stdout;
+    } else if ((outputFile = fopen(path, "w")) == NULL) {
+        printf("Error while opening file!\n");
+        exit(1);
+    }
+
+    // Write whole words until the text is large enough
+    randomState = seed;
+    buildPools();
+    while (written < textSize) {
+        emitWord();
+        emitDelimiter();
+    }
+    if (fwrite(output, 1, outputSize, outputFile) != outputSize ||
+        fclose(outputFile) != 0) {
+        perror("Error while writing the text.\n");
+        exit(1);
+    }
+
+    exit(EXIT_SUCCESS);
+}
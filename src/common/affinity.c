@@ -0,0 +1,234 @@
+/**
+ *  \file affinity.c (implementation file)
+ *
+ *  \brief Choice of the number of worker threads and of the CPUs they run on.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#define _GNU_SOURCE
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "affinity.h"
+
+/** \brief maximum length of the paths read from sysfs and procfs. */
+#define PATHSIZE 512
+
+/**
+ *  \brief Reading of a single integer from a file.
+ *
+ *  \param path path to the file.
+ *  \param value value read.
+ *
+ *  \return false if the file cannot be read.
+ */
+static bool readInteger(const char* path, long* value) {
+    FILE* file = fopen(path, "r");
+    bool ok;
+
+    if (file == NULL) {
+        return false;
+    }
+    ok = fscanf(file, "%ld", value) == 1;
+    fclose(file);
+    return ok;
+}
+
+/**
+ *  \brief Number of CPUs granted by a quota, rounded up.
+ *
+ *  \param quota CPU time available per period (negative if unlimited).
+ *  \param period length of the period.
+ *
+ *  \return number of CPUs (0 if unlimited).
+ */
+static int quotaCpus(long quota, long period) {
+    if (quota <= 0 || period <= 0) {
+        return 0;
+    }
+    return (int)((quota + period - 1) / period);
+}
+
+/**
+ *  \brief Number of CPUs granted by the cgroup quota of the process.
+ *
+ *  The cgroup v2 hierarchy ('cpu.max' of the cgroup of the process, then of
+ * the root) is tried first, then the v1 'cpu' controller.
+ *
+ *  \return number of CPUs (0 if unlimited or unknown).
+ */
+static int cgroupCpuLimit(void) {
+    char path[PATHSIZE + sizeof("/sys/fs/cgroup/cpu.max")] = "";
+    char line[PATHSIZE];
+    FILE* file;
+    long quota, period;
+    int cpus = 0;
+
+    // Find the cgroup v2 of the process
+    if ((file = fopen("/proc/self/cgroup", "r")) != NULL) {
+        while (fgets(line, sizeof(line), file) != NULL) {
+            if (strncmp(line, "0::", 3) == 0) {
+                line[strcspn(line, "\n")] = '\0';
+                snprintf(path, sizeof(path), "/sys/fs/cgroup%s/cpu.max",
+                         line + 3);
+                break;
+            }
+        }
+        fclose(file);
+    }
+
+    // cgroup v2: "<quota|max> <period>"
+    const char* maxPaths[] = {path, "/sys/fs/cgroup/cpu.max"};
+    for (int i = 0; i < 2 && cpus == 0; i++) {
+        if (maxPaths[i][0] == '\0' ||
+            (file = fopen(maxPaths[i], "r")) == NULL) {
+            continue;
+        }
+        if (fscanf(file, "%ld %ld", &quota, &period) == 2) {
+            cpus = quotaCpus(quota, period);
+        }
+        fclose(file);
+    }
+
+    // cgroup v1
+    if (cpus == 0 &&
+        readInteger("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", &quota) &&
+        readInteger("/sys/fs/cgroup/cpu/cpu.cfs_period_us", &period)) {
+        cpus = quotaCpus(quota, period);
+    }
+    return cpus;
+}
+
+/**
+ *  \brief Identifier of the physical core of a CPU.
+ *
+ *  \param cpu CPU number.
+ *
+ *  \return package and core identifiers combined (the CPU number itself if the
+ * topology is unknown).
+ */
+static long physicalCoreId(int cpu) {
+    char path[PATHSIZE];
+    long package, core;
+
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    if (!readInteger(path, &package)) {
+        return -1 - cpu;
+    }
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+    if (!readInteger(path, &core)) {
+        return -1 - cpu;
+    }
+    return (package << 20) | core;
+}
+
+bool parseWorkerCount(const char* arg, int* numWorkers) {
+    char* end;
+    long value;
+
+    if (strcmp(arg, "auto") == 0) {
+        *numWorkers = 0;
+        return true;
+    }
+    value = strtol(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0' || value <= 0 || value > 4096) {
+        return false;
+    }
+    *numWorkers = (int)value;
+    return true;
+}
+
+bool planWorkers(int requested, struct workerPlan* plan) {
+    cpu_set_t allowed;
+    long* coreIds;
+    int numCpus = 0, numSiblings = 0;
+
+    memset(plan, 0, sizeof(*plan));
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        CPU_SET(0, &allowed);
+    }
+    plan->allowedCpus = CPU_COUNT(&allowed);
+    plan->cgroupCpus = cgroupCpuLimit();
+    plan->cpus = malloc(sizeof(int) * plan->allowedCpus);
+    coreIds = malloc(sizeof(long) * plan->allowedCpus);
+    if (plan->cpus == NULL || coreIds == NULL) {
+        free(coreIds);
+        freeWorkerPlan(plan);
+        return false;
+    }
+
+    // One CPU per physical core first, their siblings at the end
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        long coreId = physicalCoreId(cpu);
+        bool newCore = true;
+        for (int i = 0; i < plan->physicalCores; i++) {
+            if (coreIds[i] == coreId) {
+                newCore = false;
+                break;
+            }
+        }
+        if (newCore) {
+            coreIds[plan->physicalCores] = coreId;
+            plan->cpus[plan->physicalCores++] = cpu;
+        } else {
+            plan->cpus[plan->allowedCpus - 1 - numSiblings++] = cpu;
+        }
+        numCpus++;
+    }
+    free(coreIds);
+
+    // Siblings were stored backwards: restore the order of the CPU numbers
+    for (int i = 0; i < numSiblings / 2; i++) {
+        int tmp = plan->cpus[plan->physicalCores + i];
+        plan->cpus[plan->physicalCores + i] = plan->cpus[numCpus - 1 - i];
+        plan->cpus[numCpus - 1 - i] = tmp;
+    }
+
+    // Choose the number of workers
+    if (requested > 0) {
+        plan->numWorkers = requested;
+    } else {
+        plan->numWorkers = plan->physicalCores;
+        if (plan->cgroupCpus > 0 && plan->cgroupCpus < plan->numWorkers) {
+            plan->numWorkers = plan->cgroupCpus;
+        }
+    }
+    return true;
+}
+
+int pinWorker(const struct workerPlan* plan, pthread_t thread, int workerId) {
+    cpu_set_t cpus;
+
+    if (plan->allowedCpus == 0) {
+        return 0;
+    }
+    CPU_ZERO(&cpus);
+    CPU_SET(plan->cpus[workerId % plan->allowedCpus], &cpus);
+    return pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+}
+
+void printWorkerPlan(const struct workerPlan* plan) {
+    printf("Effective parallelism: %d worker(s) on %d CPU(s) allowed, "
+           "%d physical core(s), ",
+           plan->numWorkers, plan->allowedCpus, plan->physicalCores);
+    if (plan->cgroupCpus > 0) {
+        printf("cgroup quota of %d CPU(s).\n", plan->cgroupCpus);
+    } else {
+        printf("no cgroup quota.\n");
+    }
+}
+
+void freeWorkerPlan(struct workerPlan* plan) {
+    free(plan->cpus);
+    plan->cpus = NULL;
+}
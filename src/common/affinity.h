@@ -0,0 +1,93 @@
+/**
+ *  \file affinity.h (interface file)
+ *
+ *  \brief Choice of the number of worker threads and of the CPUs they run on.
+ *
+ *  The parallelism available to the process is bounded by its CPU affinity
+ * mask (sched_getaffinity) and by the CPU quota of its cgroup (v2 'cpu.max' or
+ * v1 'cpu.cfs_quota_us'). Workers are pinned to distinct physical cores first;
+ * the hyper-threaded siblings of those cores are only used once every core has
+ * a worker.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+/**
+ *  \brief structure describing the workers to launch and where they run.
+ */
+struct workerPlan {
+    /** \brief number of worker threads to launch. */
+    int numWorkers;
+
+    /** \brief number of CPUs in the affinity mask of the process. */
+    int allowedCpus;
+
+    /** \brief number of CPUs granted by the cgroup quota (0 if unlimited). */
+    int cgroupCpus;
+
+    /** \brief number of distinct physical cores among the allowed CPUs. */
+    int physicalCores;
+
+    /** \brief allowed CPUs, one per physical core first, then their siblings. */
+    int* cpus;
+};
+
+/**
+ *  \brief Parsing of a worker count given on the command line.
+ *
+ *  \param arg argument to parse (a positive number or "auto").
+ *  \param numWorkers number of workers requested (0 for "auto").
+ *
+ *  \return false if the argument is not valid.
+ */
+extern bool parseWorkerCount(const char* arg, int* numWorkers);
+
+/**
+ *  \brief Choice of the number of workers and of their CPUs.
+ *
+ *  \param requested number of workers requested (0 to use one worker per
+ * physical core available, within the cgroup quota).
+ *  \param plan plan of the workers.
+ *
+ *  \return false if memory could not be allocated.
+ */
+extern bool planWorkers(int requested, struct workerPlan* plan);
+
+/**
+ *  \brief Pinning of a worker thread to its CPU.
+ *
+ *  Workers are assigned the CPUs of the plan in order (wrapping around when
+ * there are more workers than CPUs).
+ *
+ *  \param plan plan of the workers.
+ *  \param thread worker thread.
+ *  \param workerId internal worker thread identifier.
+ *
+ *  \return 0 on success, or an error number.
+ */
+extern int pinWorker(const struct workerPlan* plan, pthread_t thread,
+                     int workerId);
+
+/**
+ *  \brief Presentation of the effective parallelism of the plan.
+ *
+ *  \param plan plan of the workers.
+ *
+ */
+extern void printWorkerPlan(const struct workerPlan* plan);
+
+/**
+ *  \brief Release of the memory held by a plan.
+ *
+ *  \param plan plan of the workers.
+ *
+ */
+extern void freeWorkerPlan(struct workerPlan* plan);
+
+#endif /* AFFINITY_H */
@@ -0,0 +1,111 @@
+/**
+ *  \file arena.c (implementation file)
+ *
+ *  \brief Run-scoped memory arena.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "histogram.h"
+
+/**
+ *  \brief Size rounded up to whole cache lines.
+ *
+ *  \param size size (number of bytes).
+ *
+ *  \return size (number of bytes) rounded up.
+ */
+static size_t cacheLines(size_t size) {
+    return (size + CACHELINESIZE - 1) / CACHELINESIZE * CACHELINESIZE;
+}
+
+/**
+ *  \brief Allocation of a block of an arena.
+ *
+ *  The block header takes the first cache line, the rest is free.
+ *
+ *  \param arena arena to grow.
+ *  \param size size (number of bytes) of the free part of the block.
+ *
+ *  \return first free byte of the block (NULL if memory could not be
+ * allocated).
+ */
+static char* newBlock(struct arena* arena, size_t size) {
+    struct arenaBlock* block;
+
+    if ((block = aligned_alloc(CACHELINESIZE, CACHELINESIZE + size)) == NULL) {
+        return NULL;
+    }
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->numBlocks++;
+    arena->bytesReserved += CACHELINESIZE + size;
+    return (char*)block + CACHELINESIZE;
+}
+
+bool initArena(struct arena* arena, size_t blockSize) {
+    arena->blocks = NULL;
+    arena->next = NULL;
+    arena->left = 0;
+    arena->blockSize = cacheLines(blockSize);
+    arena->numAllocs = 0;
+    arena->numBlocks = 0;
+    arena->bytesReserved = 0;
+    return pthread_mutex_init(&arena->lock, NULL) == 0;
+}
+
+void* arenaAlloc(struct arena* arena, size_t size) {
+    char* slice;
+
+    size = cacheLines(size);
+    pthread_mutex_lock(&arena->lock);
+    if (size > arena->blockSize) {
+        // A large slice gets a block of its own, the current one stays in use
+        slice = newBlock(arena, size);
+    } else {
+        if (size > arena->left) {
+            if ((arena->next = newBlock(arena, arena->blockSize)) == NULL) {
+                arena->left = 0;
+            } else {
+                arena->left = arena->blockSize;
+            }
+        }
+        slice = arena->next;
+        if (slice != NULL) {
+            arena->next += size;
+            arena->left -= size;
+        }
+    }
+    if (slice != NULL) {
+        arena->numAllocs++;
+    }
+    pthread_mutex_unlock(&arena->lock);
+    if (slice != NULL) {
+        memset(slice, 0, size);
+    }
+    return slice;
+}
+
+void freeArena(struct arena* arena) {
+    struct arenaBlock* block = arena->blocks;
+
+    while (block != NULL) {
+        struct arenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->next = NULL;
+    arena->left = 0;
+    pthread_mutex_destroy(&arena->lock);
+}
+
+void printArenaStats(const char* owner, struct arena* arena) {
+    fprintf(stderr, "%s arena: %ld allocations, %ld blocks (%zu bytes).\n",
+            owner, arena->numAllocs, arena->numBlocks, arena->bytesReserved);
+}
@@ -0,0 +1,103 @@
+/**
+ *  \file arena.h (interface file)
+ *
+ *  \brief Run-scoped memory arena, shared by all the 'wordCount'
+ * implementations.
+ *
+ *  Memory needed for the whole run is carved out of large blocks, handed out
+ * in cache-line aligned slices and released all at once at the end of the run.
+ * The arena counts the slices handed out and the blocks taken from the system,
+ * so that a run can show that processing text makes no allocations once set
+ * up. It may be shared by several threads.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** \brief default size (number of bytes) of the blocks of an arena. */
+#define ARENABLOCKSIZE (1024 * 1024)
+
+/**
+ *  \brief structure containing the header of a block of an arena.
+ */
+struct arenaBlock {
+    /** \brief block taken from the system before this one. */
+    struct arenaBlock* next;
+};
+
+/**
+ *  \brief structure containing a memory arena.
+ */
+struct arena {
+    /** \brief lock protecting the arena. */
+    pthread_mutex_t lock;
+
+    /** \brief blocks taken from the system. */
+    struct arenaBlock* blocks;
+
+    /** \brief first free byte of the block in use. */
+    char* next;
+
+    /** \brief number of free bytes left in the block in use. */
+    size_t left;
+
+    /** \brief size (number of bytes) of the blocks. */
+    size_t blockSize;
+
+    /** \brief number of slices handed out. */
+    long numAllocs;
+
+    /** \brief number of blocks taken from the system. */
+    long numBlocks;
+
+    /** \brief number of bytes taken from the system. */
+    size_t bytesReserved;
+};
+
+/**
+ *  \brief Initialization of an empty arena.
+ *
+ *  \param arena arena to initialize.
+ *  \param blockSize size (number of bytes) of the blocks taken from the system
+ * (larger slices get a block of their own).
+ *
+ *  \return false if the arena could not be initialized.
+ */
+extern bool initArena(struct arena* arena, size_t blockSize);
+
+/**
+ *  \brief Allocation of a slice of an arena.
+ *
+ *  \param arena arena to allocate from.
+ *  \param size size (number of bytes) of the slice.
+ *
+ *  \return zeroed, cache-line aligned slice (NULL if memory could not be
+ * allocated).
+ */
+extern void* arenaAlloc(struct arena* arena, size_t size);
+
+/**
+ *  \brief Release of all the memory held by an arena.
+ *
+ *  \param arena arena to release.
+ *
+ */
+extern void freeArena(struct arena* arena);
+
+/**
+ *  \brief Presentation of the allocation counts of an arena (on the standard
+ * error, apart from the output of the program).
+ *
+ *  \param owner name of the owner of the arena.
+ *  \param arena arena.
+ *
+ */
+extern void printArenaStats(const char* owner, struct arena* arena);
+
+#endif /* ARENA_H */
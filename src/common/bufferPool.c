@@ -0,0 +1,48 @@
+/**
+ *  \file bufferPool.c (implementation file)
+ *
+ *  \brief Pool of fixed-size chunk buffers.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+
+#include "bufferPool.h"
+
+void initBufferPool(struct bufferPool* pool, struct arena* arena,
+                    size_t bufferSize) {
+    pool->arena = arena;
+    // A released buffer must hold the link to the next one
+    pool->bufferSize =
+        bufferSize < sizeof(void*) ? sizeof(void*) : bufferSize;
+    pool->freeBuffers = NULL;
+    pool->numCreated = 0;
+    pool->numAcquired = 0;
+}
+
+void* acquirePoolBuffer(struct bufferPool* pool) {
+    void* buffer = pool->freeBuffers;
+
+    if (buffer != NULL) {
+        pool->freeBuffers = *(void**)buffer;
+    } else if ((buffer = arenaAlloc(pool->arena, pool->bufferSize)) != NULL) {
+        pool->numCreated++;
+    } else {
+        return NULL;
+    }
+    pool->numAcquired++;
+    return buffer;
+}
+
+void releasePoolBuffer(struct bufferPool* pool, void* buffer) {
+    *(void**)buffer = pool->freeBuffers;
+    pool->freeBuffers = buffer;
+}
+
+void printPoolStats(const char* owner, const struct bufferPool* pool) {
+    fprintf(stderr,
+            "%s buffer pool: %ld acquisitions, %ld buffers created (%zu bytes "
+            "each).\n",
+            owner, pool->numAcquired, pool->numCreated, pool->bufferSize);
+}
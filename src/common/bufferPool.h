@@ -0,0 +1,82 @@
+/**
+ *  \file bufferPool.h (interface file)
+ *
+ *  \brief Pool of fixed-size chunk buffers, shared by all the 'wordCount'
+ * implementations.
+ *
+ *  Buffers are carved out of a run-scoped arena the first time they are needed
+ * and recycled afterwards: a released buffer is kept in a free list and handed
+ * out again by the next acquisition. Their memory goes back to the system with
+ * the arena. A pool is used by one thread at a time.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <stddef.h>
+
+#include "arena.h"
+
+/**
+ *  \brief structure containing a pool of buffers.
+ */
+struct bufferPool {
+    /** \brief arena the buffers are carved out of. */
+    struct arena* arena;
+
+    /** \brief size (number of bytes) of every buffer. */
+    size_t bufferSize;
+
+    /** \brief released buffers (each one holds the address of the next). */
+    void* freeBuffers;
+
+    /** \brief number of buffers carved out of the arena. */
+    long numCreated;
+
+    /** \brief number of buffers handed out. */
+    long numAcquired;
+};
+
+/**
+ *  \brief Initialization of an empty pool.
+ *
+ *  \param pool pool to initialize.
+ *  \param arena arena the buffers are carved out of.
+ *  \param bufferSize size (number of bytes) of every buffer.
+ *
+ */
+extern void initBufferPool(struct bufferPool* pool, struct arena* arena,
+                           size_t bufferSize);
+
+/**
+ *  \brief Acquisition of a buffer, recycled if any was released.
+ *
+ *  \param pool pool to acquire from.
+ *
+ *  \return buffer of 'bufferSize' bytes (NULL if memory could not be
+ * allocated).
+ */
+extern void* acquirePoolBuffer(struct bufferPool* pool);
+
+/**
+ *  \brief Release of a buffer for later acquisitions.
+ *
+ *  \param pool pool the buffer was acquired from.
+ *  \param buffer buffer to release.
+ *
+ */
+extern void releasePoolBuffer(struct bufferPool* pool, void* buffer);
+
+/**
+ *  \brief Presentation of the allocation counts of a pool (on the standard
+ * error, apart from the output of the program).
+ *
+ *  \param owner name of the owner of the pool.
+ *  \param pool pool.
+ *
+ */
+extern void printPoolStats(const char* owner, const struct bufferPool* pool);
+
+#endif /* BUFFERPOOL_H */
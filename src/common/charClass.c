@@ -0,0 +1,100 @@
+/**
+ *  \file charClass.c (implementation file)
+ *
+ *  \brief UTF-8 decoder and character classification shared by all the
+ * 'wordCount' implementations.
+ *
+ *  The lists of delimiters, mergers and vowels remain the single definition of
+ * the character classes; they are decoded once by 'initCharClasses' into a
+ * two-level table indexed by code point.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "charClass.h"
+
+/** \brief maximum size (number of bytes) of an entry of the character lists. */
+#define CC_MAXCHARSIZE 6
+
+/** \brief array containing all the characters defined as word delimiters. */
+static const char delimiters[25][CC_MAXCHARSIZE] = {
+    " ", "-", "–", "—",  ".",  ",",  ":",  ";", "(", ")", "[", "]", "{",
+    "}", "?", "!", "\n", "\t", "\r", "\"", "“", "”", "«", "»", "…"};
+
+/** \brief array containing all the characters defined as word mergers. */
+static const char mergers[7][CC_MAXCHARSIZE] = {"‘", "’", "´", "`",
+                                                "'", "ü", "Ü"};
+
+/** \brief array containing all the possible vowels. */
+static const char vowels[48][CC_MAXCHARSIZE] = {
+    "a", "e", "i", "o", "u", "A", "E", "I", "O", "U", "á", "à",
+    "ã", "â", "ä", "é", "è", "ẽ", "ê", "ë", "Á", "À", "Ã", "Â",
+    "Ä", "É", "È", "Ẽ", "Ê", "Ë", "ó", "ò", "õ", "ô", "ö", "Ó",
+    "Ò", "Õ", "Ô", "Ö", "í", "ì", "Í", "Ì", "ú", "ù", "Ú", "Ù"};
+
+unsigned char utf8Length[256];
+unsigned char charClassPageIdx[CC_NUMPAGES];
+unsigned char charClassPages[CC_MAXPAGES][CC_PAGESIZE];
+
+/** \brief number of pages of the class table currently in use. */
+static int numPages;
+
+/**
+ *  \brief Assignment of a class to every character of a list.
+ *
+ *  \param list array of UTF-8 encoded characters.
+ *  \param listSize number of entries of 'list'.
+ *  \param charClass class bitmask assigned to the entries.
+ *
+ */
+static void classifyList(const char list[][CC_MAXCHARSIZE], int listSize,
+                         int charClass) {
+    for (int i = 0; i < listSize; i++) {
+        unsigned int cp;
+        decodeChar(list[i], strlen(list[i]), &cp);
+        if (cp == CC_INVALID) {
+            continue;
+        }
+
+        // Give the code point's block a page of its own (if it still uses the
+        // default one)
+        unsigned int page = cp / CC_PAGESIZE;
+        if (charClassPageIdx[page] == 0) {
+            if (numPages == CC_MAXPAGES) {
+                fprintf(stderr, "Too many character pages to classify.\n");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(charClassPages[numPages], charClassPages[0], CC_PAGESIZE);
+            charClassPageIdx[page] = numPages++;
+        }
+        charClassPages[charClassPageIdx[page]][cp % CC_PAGESIZE] = charClass;
+    }
+}
+
+void initCharClasses(void) {
+    // Verify the number of 1s in the most significant bits of every byte
+    // (0xC0 and 0xC1 only start overlong sequences, and 0xF5 onwards code
+    // points out of range or longer sequences than UTF-8 has)
+    for (int b = 0; b < 256; b++) {
+        int ones = 0;
+        while (ones < 8 && ((b >> (7 - ones)) & 1)) {
+            ones++;
+        }
+        utf8Length[b] = ones > 1 && b >= 0xC2 && b <= 0xF4 ? ones : 1;
+    }
+
+    // Every code point is a letter unless listed otherwise
+    memset(charClassPageIdx, 0, sizeof(charClassPageIdx));
+    memset(charClassPages[0], CC_LETTER, CC_PAGESIZE);
+    numPages = 1;
+
+    classifyList(delimiters, sizeof(delimiters) / sizeof(delimiters[0]),
+                 CC_DELIMITER);
+    classifyList(mergers, sizeof(mergers) / sizeof(mergers[0]), CC_MERGER);
+    classifyList(vowels, sizeof(vowels) / sizeof(vowels[0]),
+                 CC_VOWEL | CC_LETTER);
+}
@@ -0,0 +1,156 @@
+/**
+ *  \file charClass.h (interface file)
+ *
+ *  \brief UTF-8 decoder and character classification shared by all the
+ * 'wordCount' implementations.
+ *
+ *  Every code point is mapped to a class bitmask (delimiter, merger, vowel,
+ * letter) through a two-level lookup table built once at program start from the
+ * lists of delimiters, mergers and vowels. Classifying a character therefore
+ * costs a decode plus two table reads instead of a string comparison against
+ * every entry of those lists.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <stddef.h>
+
+/** \brief class bit of the characters that separate words. */
+#define CC_DELIMITER 0x01
+
+/** \brief class bit of the characters that join words without counting as a
+ * letter. */
+#define CC_MERGER 0x02
+
+/** \brief class bit of the characters counted as vowels. */
+#define CC_VOWEL 0x04
+
+/** \brief class bit of the characters that count towards a word's size. */
+#define CC_LETTER 0x08
+
+/** \brief code point assigned to malformed or unsupported byte sequences. */
+#define CC_INVALID 0xFFFFFFFFu
+
+/** \brief number of code points covered by each page of the class table. */
+#define CC_PAGESIZE 256
+
+/** \brief number of pages indexed by the class table (whole Unicode range). */
+#define CC_NUMPAGES (0x110000 / CC_PAGESIZE)
+
+/** \brief maximum number of distinct pages the class table may hold. */
+#define CC_MAXPAGES 8
+
+/** \brief length (number of bytes) of the sequence started by each byte (1 for
+ * a byte that cannot start a multi-byte one). */
+extern unsigned char utf8Length[256];
+
+/** \brief page of the class table used by each block of 256 code points. */
+extern unsigned char charClassPageIdx[CC_NUMPAGES];
+
+/** \brief pages of the class table (page 0 holds the default class). */
+extern unsigned char charClassPages[CC_MAXPAGES][CC_PAGESIZE];
+
+/**
+ *  \brief Construction of the decoding and classification tables.
+ *
+ *  Must be called once, before any character is classified (and before any
+ * worker is launched).
+ *
+ */
+extern void initCharClasses(void);
+
+/**
+ *  \brief Decoding of a single UTF-8 character.
+ *
+ *  The length of a sequence is given by the number of 1s in the most
+ * significant bits of its first byte, as in the original byte-by-byte readers.
+ * A sequence that is malformed (a byte that cannot start one, a missing
+ * continuation byte, an overlong encoding or a code point out of range) or cut
+ * short by the end of the bytes available only consumes its first byte, so
+ * that no delimiter following it is swallowed.
+ *
+ *  \param text pointer to the first byte of the character.
+ *  \param avail number of bytes available from 'text' onwards.
+ *  \param codePoint decoded code point (CC_INVALID if malformed).
+ *
+ *  \return number of bytes consumed.
+ */
+static inline int decodeChar(const char* text, size_t avail,
+                             unsigned int* codePoint) {
+    const unsigned char* s = (const unsigned char*)text;
+    int len = utf8Length[s[0]];
+    unsigned int cp;
+
+    *codePoint = CC_INVALID;
+    if ((size_t)len > avail) {
+        return 1;
+    }
+    for (int i = 1; i < len; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            return 1;
+        }
+    }
+    switch (len) {
+        case 1:
+            if (s[0] < 0x80) {
+                *codePoint = s[0];
+            }
+            return 1;
+        case 2:
+            *codePoint = ((s[0] & 0x1F) << 6) | (s[1] & 0x3F);
+            return 2;
+        case 3:
+            cp = ((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+            if (cp < 0x800) {
+                return 1;
+            }
+            *codePoint = cp;
+            return 3;
+        default:
+            cp = ((s[0] & 0x07) << 18) | ((s[1] & 0x3F) << 12) |
+                 ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+            if (cp < 0x10000 || cp >= 0x110000) {
+                return 1;
+            }
+            *codePoint = cp;
+            return 4;
+    }
+}
+
+/**
+ *  \brief Class bitmask of a code point.
+ *
+ *  \param codePoint code point to classify.
+ *
+ *  \return combination of the CC_* class bits.
+ */
+static inline int codePointClass(unsigned int codePoint) {
+    // A malformed byte neither counts towards a word nor splits it
+    if (codePoint >= 0x110000) {
+        return CC_MERGER;
+    }
+    return charClassPages[charClassPageIdx[codePoint / CC_PAGESIZE]]
+                         [codePoint % CC_PAGESIZE];
+}
+
+/**
+ *  \brief Decoding and classification of a single UTF-8 character.
+ *
+ *  \param text pointer to the first byte of the character.
+ *  \param avail number of bytes available from 'text' onwards.
+ *  \param charClass class bitmask of the character.
+ *
+ *  \return number of bytes consumed.
+ */
+static inline int classifyChar(const char* text, size_t avail,
+                               int* charClass) {
+    unsigned int cp;
+    int len = decodeChar(text, avail, &cp);
+    *charClass = codePointClass(cp);
+    return len;
+}
+
+#endif /* CHARCLASS_H */
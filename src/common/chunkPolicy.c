@@ -0,0 +1,50 @@
+/**
+ *  \file chunkPolicy.c (implementation file)
+ *
+ *  \brief Choice of the size of the text chunks handed out to the workers.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "chunkPolicy.h"
+
+bool parseChunkSize(const char* arg, size_t* size) {
+    unsigned long long multiplier = 1;
+    char* end;
+    unsigned long long value = strtoull(arg, &end, 10);
+
+    if (end == arg || value == 0 || !isdigit((unsigned char)arg[0])) {
+        return false;
+    }
+    switch (*end) {
+        case 'G':
+        case 'g':
+            multiplier *= 1024;
+            /* fall through */
+        case 'M':
+        case 'm':
+            multiplier *= 1024;
+            /* fall through */
+        case 'K':
+        case 'k':
+            multiplier *= 1024;
+            end++;
+            break;
+        default:
+            break;
+    }
+
+    // Sizes are also counted in signed integers (e.g. by 'read' and the worker
+    // statistics), so they must fit in a long, and in a size_t
+    if (*end != '\0' || value > LONG_MAX / multiplier ||
+        value > SIZE_MAX / multiplier) {
+        return false;
+    }
+    *size = (size_t)(value * multiplier);
+    return true;
+}
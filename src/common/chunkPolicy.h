@@ -0,0 +1,92 @@
+/**
+ *  \file chunkPolicy.h (interface file)
+ *
+ *  \brief Choice of the size of the text chunks handed out to the workers.
+ *
+ *  Chunks start large, so that most of the input is handed out in a few
+ * claims, and shrink as the end of the input approaches: each chunk takes a
+ * fixed fraction of the bytes left per worker, so the last chunks are small and
+ * all workers finish at about the same time.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef CHUNKPOLICY_H
+#define CHUNKPOLICY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** \brief default largest size (number of bytes) of a text chunk. */
+#define MAXCHUNKSIZE (2 * 1024 * 1024)
+
+/** \brief smallest size (number of bytes) of a text chunk (unless the largest
+ * size is set below it). */
+#define MINCHUNKSIZE (64 * 1024)
+
+/** \brief number of chunks each worker should still get from the bytes left. */
+#define CHUNKSPERWORKER 2
+
+/**
+ *  \brief structure containing the parameters of the chunk size policy.
+ */
+struct chunkPolicy {
+    /** \brief largest size (number of bytes) of a chunk. */
+    size_t maxSize;
+
+    /** \brief smallest size (number of bytes) of a chunk. */
+    size_t minSize;
+
+    /** \brief number of workers sharing the input. */
+    int numWorkers;
+};
+
+/**
+ *  \brief Initialization of a chunk size policy.
+ *
+ *  \param policy policy to initialize.
+ *  \param maxSize largest size (number of bytes) of a chunk.
+ *  \param numWorkers number of workers sharing the input.
+ *
+ */
+static inline void initChunkPolicy(struct chunkPolicy* policy, size_t maxSize,
+                                   int numWorkers) {
+    policy->maxSize = maxSize;
+    policy->minSize = maxSize < MINCHUNKSIZE ? maxSize : MINCHUNKSIZE;
+    policy->numWorkers = numWorkers > 0 ? numWorkers : 1;
+}
+
+/**
+ *  \brief Size of the next chunk.
+ *
+ *  \param policy chunk size policy.
+ *  \param remaining number of bytes of the input not yet handed out.
+ *
+ *  \return size (number of bytes) of the next chunk.
+ */
+static inline size_t nextChunkSize(const struct chunkPolicy* policy,
+                                   size_t remaining) {
+    size_t size = remaining / ((size_t)CHUNKSPERWORKER * policy->numWorkers);
+
+    if (size > policy->maxSize) {
+        return policy->maxSize;
+    }
+    if (size < policy->minSize) {
+        return policy->minSize;
+    }
+    return size;
+}
+
+/**
+ *  \brief Parsing of a chunk size given on the command line.
+ *
+ *  \param arg argument to parse (a number of bytes, optionally followed by 'K',
+ * 'M' or 'G').
+ *  \param size size (number of bytes) parsed.
+ *
+ *  \return false if the argument is not valid, or its size does not fit in a
+ * long.
+ */
+extern bool parseChunkSize(const char* arg, size_t* size);
+
+#endif /* CHUNKPOLICY_H */
@@ -0,0 +1,124 @@
+/**
+ *  \file histogram.c (implementation file)
+ *
+ *  \brief Sparse map of the occurrence frequencies of long words.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "histogram.h"
+
+/** \brief number of entries of a map when its first word is added. */
+#define OVERFLOWSIZE 16
+
+/**
+ *  \brief Slot of the entry of a given size and number of vowels.
+ *
+ *  \param map map to search.
+ *  \param size number of characters of the words.
+ *  \param vowels number of vowels of the words.
+ *
+ *  \return entry holding the key, or the unused entry where it belongs.
+ */
+static struct longWord* findLongWord(const struct overflowMap* map, int size,
+                                     int vowels) {
+    unsigned int mask = (unsigned int)map->capacity - 1;
+    unsigned int idx =
+        ((unsigned int)size * 2654435761u ^ (unsigned int)vowels) & mask;
+
+    while (map->entries[idx].size != 0 && (map->entries[idx].size != size ||
+                                           map->entries[idx].vowels != vowels)) {
+        idx = (idx + 1) & mask;
+    }
+    return &map->entries[idx];
+}
+
+/**
+ *  \brief Growth of a map to twice its number of entries.
+ *
+ *  \param map map to grow.
+ *
+ */
+static void growOverflow(struct overflowMap* map) {
+    struct overflowMap grown;
+
+    grown.capacity = map->capacity > 0 ? 2 * map->capacity : OVERFLOWSIZE;
+    grown.numEntries = map->numEntries;
+    if ((grown.entries = calloc(grown.capacity, sizeof(struct longWord))) ==
+        NULL) {
+        perror("Error while allocating memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->entries[i].size != 0) {
+            *findLongWord(&grown, map->entries[i].size,
+                          map->entries[i].vowels) = map->entries[i];
+        }
+    }
+    free(map->entries);
+    *map = grown;
+}
+
+void addLongWords(struct overflowMap* map, int size, int vowels, int count) {
+    struct longWord* entry;
+
+    // Keep the table at most half full
+    if (2 * (map->numEntries + 1) > map->capacity) {
+        growOverflow(map);
+    }
+    entry = findLongWord(map, size, vowels);
+    if (entry->size == 0) {
+        entry->size = size;
+        entry->vowels = vowels;
+        map->numEntries++;
+    }
+    entry->count += count;
+}
+
+void mergeOverflow(struct overflowMap* dst, const struct overflowMap* src) {
+    for (int i = 0; i < src->capacity && src->numEntries > 0; i++) {
+        if (src->entries[i].size != 0) {
+            addLongWords(dst, src->entries[i].size, src->entries[i].vowels,
+                         src->entries[i].count);
+        }
+    }
+}
+
+/**
+ *  \brief Comparison of two entries by size, then number of vowels.
+ *
+ *  \param a first entry.
+ *  \param b second entry.
+ *
+ *  \return negative, zero or positive as 'a' sorts before, with or after 'b'.
+ */
+static int compareLongWords(const void* a, const void* b) {
+    const struct longWord* x = a;
+    const struct longWord* y = b;
+
+    if (x->size != y->size) {
+        return x->size < y->size ? -1 : 1;
+    }
+    return (x->vowels > y->vowels) - (x->vowels < y->vowels);
+}
+
+void sortedLongWords(const struct overflowMap* map, struct longWord* entries) {
+    int n = 0;
+
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->entries[i].size != 0) {
+            entries[n++] = map->entries[i];
+        }
+    }
+    qsort(entries, n, sizeof(struct longWord), compareLongWords);
+}
+
+void freeOverflow(struct overflowMap* map) {
+    free(map->entries);
+    map->entries = NULL;
+    map->numEntries = 0;
+    map->capacity = 0;
+}
@@ -0,0 +1,222 @@
+/**
+ *  \file histogram.h (interface file)
+ *
+ *  \brief Definition of the structure accumulating the word size and vowel
+ * count frequencies of a portion of text.
+ *
+ *  Words shorter than HISTSIZE are counted in dense arrays indexed by size and
+ * number of vowels. Longer words, which are rare, go to a small sparse map
+ * keyed by (size, vowels), allocated on the first of them; the check that
+ * routes them there is only made when a word exceeds the largest size recorded
+ * so far, so the common path has no extra branch.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <string.h>
+
+/** \brief number of word sizes (and of vowel counts) counted in dense arrays. */
+#define HISTSIZE 50
+
+/** \brief size (number of bytes) of a cache line. */
+#define CACHELINESIZE 64
+
+/**
+ *  \brief structure containing the number of occurrences of a long word size
+ * and vowel count.
+ */
+struct longWord {
+    /** \brief number of characters of the words (0 if the entry is unused). */
+    int size;
+
+    /** \brief number of vowels of the words. */
+    int vowels;
+
+    /** \brief number of words found with this size and number of vowels. */
+    int count;
+};
+
+/**
+ *  \brief structure containing the occurrence frequencies of the words that do
+ * not fit the dense arrays (open addressing hash table).
+ */
+struct overflowMap {
+    /** \brief table of entries (NULL until the first long word). */
+    struct longWord* entries;
+
+    /** \brief number of entries in use. */
+    int numEntries;
+
+    /** \brief number of entries of the table (a power of 2). */
+    int capacity;
+};
+
+/**
+ *  \brief structure containing the occurrence frequencies of word sizes and
+ * vowel counts.
+ *
+ *  Histograms are aligned (and padded) to a cache line, so histograms updated
+ * by different threads never share one.
+ */
+struct __attribute__((aligned(CACHELINESIZE))) histogram {
+    /** \brief array containing the number of words found whose size is equal
+     * to the respective index. */
+    int wordSize[HISTSIZE];
+
+    /** \brief 2D array containing the number of words found whose number of
+     * vowels and word size are equal to x and y. */
+    int vowelCount[HISTSIZE][HISTSIZE];
+
+    /** \brief largest word size recorded in the dense arrays. */
+    int maxWordSize;
+
+    /** \brief largest number of vowels recorded in the dense arrays. */
+    int maxVowelCount;
+
+    /** \brief occurrence frequencies of the words longer than the dense
+     * arrays. */
+    struct overflowMap overflow;
+};
+
+/**
+ *  \brief Addition of occurrences to a sparse map.
+ *
+ *  Exits the program if memory cannot be allocated.
+ *
+ *  \param map map to update.
+ *  \param size number of characters of the words.
+ *  \param vowels number of vowels of the words.
+ *  \param count number of words to add.
+ *
+ */
+extern void addLongWords(struct overflowMap* map, int size, int vowels,
+                         int count);
+
+/**
+ *  \brief Accumulation of a sparse map into another.
+ *
+ *  \param dst map to update.
+ *  \param src map whose occurrences are added to 'dst'.
+ *
+ */
+extern void mergeOverflow(struct overflowMap* dst,
+                          const struct overflowMap* src);
+
+/**
+ *  \brief Copy of the entries in use of a sparse map, sorted by size and
+ * number of vowels.
+ *
+ *  \param map map to read.
+ *  \param entries array receiving 'map->numEntries' entries.
+ *
+ */
+extern void sortedLongWords(const struct overflowMap* map,
+                            struct longWord* entries);
+
+/**
+ *  \brief Release of the memory held by a sparse map.
+ *
+ *  \param map map to release.
+ *
+ */
+extern void freeOverflow(struct overflowMap* map);
+
+/**
+ *  \brief Initialization of a histogram.
+ *
+ *  \param hist histogram to initialize.
+ *
+ */
+static inline void initHistogram(struct histogram* hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+/**
+ *  \brief Reset of a histogram.
+ *
+ *  Only the region touched since the last reset is cleared.
+ *
+ *  \param hist histogram to reset.
+ *
+ */
+static inline void clearHistogram(struct histogram* hist) {
+    memset(hist->wordSize, 0, sizeof(int) * (hist->maxWordSize + 1));
+    for (int i = 0; i <= hist->maxVowelCount; i++) {
+        memset(hist->vowelCount[i], 0, sizeof(int) * (hist->maxWordSize + 1));
+    }
+    hist->maxWordSize = 0;
+    hist->maxVowelCount = 0;
+    if (hist->overflow.numEntries > 0) {
+        memset(hist->overflow.entries, 0,
+               sizeof(struct longWord) * hist->overflow.capacity);
+        hist->overflow.numEntries = 0;
+    }
+}
+
+/**
+ *  \brief Release of the memory held by a histogram.
+ *
+ *  \param hist histogram to release.
+ *
+ */
+static inline void freeHistogram(struct histogram* hist) {
+    freeOverflow(&hist->overflow);
+}
+
+/**
+ *  \brief Registration of a word in a histogram.
+ *
+ *  \param hist histogram to update.
+ *  \param size number of characters of the word.
+ *  \param vowels number of vowels of the word.
+ *
+ */
+static inline void recordWord(struct histogram* hist, int size, int vowels) {
+    if (size > hist->maxWordSize || vowels > hist->maxVowelCount) {
+        if (size >= HISTSIZE || vowels >= HISTSIZE) {
+            addLongWords(&hist->overflow, size, vowels, 1);
+            return;
+        }
+        if (size > hist->maxWordSize) {
+            hist->maxWordSize = size;
+        }
+        if (vowels > hist->maxVowelCount) {
+            hist->maxVowelCount = vowels;
+        }
+    }
+    hist->wordSize[size]++;
+    hist->vowelCount[vowels][size]++;
+}
+
+/**
+ *  \brief Accumulation of a histogram into another.
+ *
+ *  Only the region touched in 'src' is walked.
+ *
+ *  \param dst histogram to update.
+ *  \param src histogram whose frequencies are added to 'dst'.
+ *
+ */
+static inline void mergeHistogram(struct histogram* dst,
+                                  const struct histogram* src) {
+    for (int j = 0; j <= src->maxWordSize; j++) {
+        dst->wordSize[j] += src->wordSize[j];
+    }
+    for (int i = 0; i <= src->maxVowelCount; i++) {
+        for (int j = 0; j <= src->maxWordSize; j++) {
+            dst->vowelCount[i][j] += src->vowelCount[i][j];
+        }
+    }
+    if (src->maxWordSize > dst->maxWordSize) {
+        dst->maxWordSize = src->maxWordSize;
+    }
+    if (src->maxVowelCount > dst->maxVowelCount) {
+        dst->maxVowelCount = src->maxVowelCount;
+    }
+    mergeOverflow(&dst->overflow, &src->overflow);
+}
+
+#endif /* HISTOGRAM_H */
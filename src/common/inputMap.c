@@ -0,0 +1,100 @@
+/**
+ *  \file inputMap.c (implementation file)
+ *
+ *  \brief Memory-mapped access to the text files given as input.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "inputMap.h"
+
+/** \brief memory space (number of bytes) by which the copy of an input that
+ * cannot be mapped grows. */
+#define READSIZE 65536
+
+/**
+ *  \brief Reading of a whole input into memory.
+ *
+ *  \param fd descriptor of the input.
+ *  \param map copy of the input.
+ *
+ *  \return false if the input cannot be read.
+ */
+static bool readInput(int fd, struct inputMap* map) {
+    char* data = NULL;
+    size_t capacity = 0;
+    size_t size = 0;
+    ssize_t bytesRead;
+
+    do {
+        if (size == capacity) {
+            char* grown = realloc(data, capacity + READSIZE);
+            if (grown == NULL) {
+                free(data);
+                return false;
+            }
+            data = grown;
+            capacity += READSIZE;
+        }
+        if ((bytesRead = read(fd, data + size, capacity - size)) == -1) {
+            free(data);
+            return false;
+        }
+        size += bytesRead;
+    } while (bytesRead > 0);
+
+    map->data = data;
+    map->size = size;
+    map->mapped = false;
+    return true;
+}
+
+bool mapInput(const char* path, struct inputMap* map) {
+    struct stat info;
+    bool success = true;
+    int fd;
+
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = true;
+    if ((fd = open(path, O_RDONLY)) == -1) {
+        return false;
+    }
+    if (fstat(fd, &info) == -1) {
+        close(fd);
+        return false;
+    }
+
+    // Map the whole file (an empty file needs no mapping)
+    if (!S_ISREG(info.st_mode)) {
+        success = readInput(fd, map);
+    } else if (info.st_size > 0) {
+        void* data =
+            mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            success = readInput(fd, map);
+        } else {
+            madvise(data, info.st_size, MADV_SEQUENTIAL);
+            map->data = data;
+            map->size = info.st_size;
+        }
+    }
+    close(fd);
+    return success;
+}
+
+void unmapInput(struct inputMap* map) {
+    if (map->mapped && map->data != NULL) {
+        munmap((void*)map->data, map->size);
+    } else if (!map->mapped) {
+        free((void*)map->data);
+    }
+    map->data = NULL;
+    map->size = 0;
+}
@@ -0,0 +1,55 @@
+/**
+ *  \file inputMap.h (interface file)
+ *
+ *  \brief Memory-mapped access to the text files given as input.
+ *
+ *  A mapped file is read by the workers straight from the page cache, as
+ * ranges (offset, length) of the mapping, so no byte is read while holding a
+ * lock. Inputs that cannot be mapped (e.g. pipes) are read whole into memory
+ * instead, so they can be processed the same way.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef INPUTMAP_H
+#define INPUTMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ *  \brief structure containing the mapping of a text file.
+ */
+struct inputMap {
+    /** \brief first byte of the file (NULL if the file is empty). */
+    const char* data;
+
+    /** \brief size (number of bytes) of the file. */
+    size_t size;
+
+    /** \brief whether 'data' is a mapping (true) or a heap copy (false). */
+    bool mapped;
+};
+
+/**
+ *  \brief Mapping of a text file into memory.
+ *
+ *  The kernel is advised that the mapping will be read sequentially. Inputs
+ * that cannot be mapped are read whole into memory instead.
+ *
+ *  \param path path to the file.
+ *  \param map mapping of the file.
+ *
+ *  \return false if the file cannot be opened or read.
+ */
+extern bool mapInput(const char* path, struct inputMap* map);
+
+/**
+ *  \brief Release of the mapping of a text file.
+ *
+ *  \param map mapping of the file.
+ *
+ */
+extern void unmapInput(struct inputMap* map);
+
+#endif /* INPUTMAP_H */
@@ -0,0 +1,514 @@
+/**
+ *  \file resultWriter.c (implementation file)
+ *
+ *  \brief Buffered writing of the results of every file.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "resultWriter.h"
+
+/** \brief largest number of bytes of a formatted number. */
+#define MAXNUMBERSIZE 32
+
+/** \brief names of the formats, in the order of 'enum outputFormat'. */
+static const char* formatNames[] = {"text", "json", "csv", "binary"};
+
+bool parseOutputFormat(const char* arg, enum outputFormat* format) {
+    for (int i = 0; i < (int)(sizeof(formatNames) / sizeof(formatNames[0]));
+         i++) {
+        if (strcmp(arg, formatNames[i]) == 0) {
+            *format = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void flushResultWriter(struct resultWriter* writer) {
+    if (writer->used > 0 &&
+        fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        perror("Error while writing the results.\n");
+        exit(EXIT_FAILURE);
+    }
+    writer->used = 0;
+    fflush(writer->file);
+}
+
+/**
+ *  \brief Writing of bytes to the buffer of a writer.
+ *
+ *  \param writer writer to use.
+ *  \param data bytes to write.
+ *  \param len number of bytes of 'data'.
+ *
+ */
+static void putBytes(struct resultWriter* writer, const void* data,
+                     size_t len) {
+    // Only text larger than the whole buffer skips it
+    if (writer->used + len > WRITERBUFFERSIZE) {
+        flushResultWriter(writer);
+        if (len > WRITERBUFFERSIZE) {
+            if (fwrite(data, 1, len, writer->file) != len) {
+                perror("Error while writing the results.\n");
+                exit(EXIT_FAILURE);
+            }
+            return;
+        }
+    }
+    memcpy(writer->buffer + writer->used, data, len);
+    writer->used += len;
+}
+
+/**
+ *  \brief Writing of a null-terminated string to the buffer of a writer.
+ *
+ *  \param writer writer to use.
+ *  \param text string to write.
+ *
+ */
+static void putString(struct resultWriter* writer, const char* text) {
+    putBytes(writer, text, strlen(text));
+}
+
+/**
+ *  \brief Writing of digits right-aligned in a field (like printf's "%*s").
+ *
+ *  \param writer writer to use.
+ *  \param digits text of the number.
+ *  \param len number of bytes of 'digits'.
+ *  \param width smallest size of the field.
+ *
+ */
+static void putField(struct resultWriter* writer, const char* digits, int len,
+                     int width) {
+    static const char spaces[MAXNUMBERSIZE] = "                               ";
+
+    if (width > len) {
+        putBytes(writer, spaces,
+                 width - len < MAXNUMBERSIZE ? width - len : MAXNUMBERSIZE - 1);
+    }
+    putBytes(writer, digits, len);
+}
+
+/**
+ *  \brief Formatting of an unsigned integer, leaving its digits at the end of
+ * a buffer.
+ *
+ *  \param value number to format.
+ *  \param end end of the buffer.
+ *  \param minDigits smallest number of digits (padded with zeros).
+ *
+ *  \return first digit.
+ */
+static char* formatDigits(uint64_t value, char* end, int minDigits) {
+    char* digits = end;
+
+    do {
+        *--digits = '0' + value % 10;
+        value /= 10;
+    } while (value > 0 || end - digits < minDigits);
+    return digits;
+}
+
+/**
+ *  \brief Writing of an integer right-aligned in a field (like printf's
+ * "%*d").
+ *
+ *  \param writer writer to use.
+ *  \param value number to write.
+ *  \param width smallest size of the field (0 for none).
+ *
+ */
+static void putInt(struct resultWriter* writer, long long value, int width) {
+    char text[MAXNUMBERSIZE];
+    char* end = text + MAXNUMBERSIZE;
+    char* digits = formatDigits(value < 0 ? -(uint64_t)value : (uint64_t)value,
+                                end, 1);
+
+    if (value < 0) {
+        *--digits = '-';
+    }
+    putField(writer, digits, end - digits, width);
+}
+
+/**
+ *  \brief Writing of a number with a fixed number of decimals right-aligned in
+ * a field (like printf's "%*.*f").
+ *
+ *  The number is rounded exactly as printf does: to the nearest decimal of its
+ * binary value, and to an even last digit on a tie. Only the numbers printf is
+ * needed for (negative, too large or not finite) go through it.
+ *
+ *  \param writer writer to use.
+ *  \param value number to write.
+ *  \param decimals number of decimals (1 to 3).
+ *  \param width smallest size of the field.
+ *
+ */
+static void putFixed(struct resultWriter* writer, double value, int decimals,
+                     int width) {
+    static const unsigned int scales[] = {1, 10, 100, 1000};
+    char text[MAXNUMBERSIZE];
+    char* end = text + MAXNUMBERSIZE;
+    unsigned __int128 scaled, rest, half;
+    uint64_t bits, mantissa, units;
+    int shift;
+
+    if (!(value >= 0 && value < 1e9)) {
+        putField(writer, text,
+                 snprintf(text, sizeof(text), "%.*f", decimals, value), width);
+        return;
+    }
+
+    // The value is mantissa / 2^shift, so its scaled value is an exact
+    // fraction whose remainder decides the rounding
+    memcpy(&bits, &value, sizeof(bits));
+    mantissa = bits & ((UINT64_C(1) << 52) - 1);
+    if ((bits >> 52) == 0) {
+        shift = 1074;
+    } else {
+        mantissa |= UINT64_C(1) << 52;
+        shift = 1075 - (int)(bits >> 52);
+    }
+    scaled = (unsigned __int128)mantissa * scales[decimals];
+    if (shift >= 120) {
+        units = 0;
+    } else {
+        units = scaled >> shift;
+        rest = scaled - ((unsigned __int128)units << shift);
+        half = (unsigned __int128)1 << (shift - 1);
+        if (rest > half || (rest == half && units % 2 == 1)) {
+            units++;
+        }
+    }
+
+    char* digits = formatDigits(units % scales[decimals], end, decimals);
+    *--digits = '.';
+    digits = formatDigits(units / scales[decimals], digits, 1);
+    putField(writer, digits, end - digits, width);
+}
+
+/**
+ *  \brief Writing of a 32-bit integer in the byte order of the machine.
+ *
+ *  \param writer writer to use.
+ *  \param value number to write.
+ *
+ */
+static void putBinaryInt(struct resultWriter* writer, int32_t value) {
+    putBytes(writer, &value, sizeof(value));
+}
+
+/**
+ *  \brief Writing of a file name as a JSON string.
+ *
+ *  \param writer writer to use.
+ *  \param text name to write.
+ *
+ */
+static void putJsonString(struct resultWriter* writer, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    char escape[6] = {'\\', 'u', '0', '0'};
+
+    putBytes(writer, "\"", 1);
+    for (; *text != '\0'; text++) {
+        unsigned char c = *text;
+        if (c == '"' || c == '\\') {
+            escape[1] = c;
+            putBytes(writer, escape, 2);
+            escape[1] = 'u';
+        } else if (c < 0x20) {
+            escape[4] = hex[c >> 4];
+            escape[5] = hex[c & 0xF];
+            putBytes(writer, escape, 6);
+        } else {
+            putBytes(writer, text, 1);
+        }
+    }
+    putBytes(writer, "\"", 1);
+}
+
+/**
+ *  \brief Writing of a file name as a CSV field.
+ *
+ *  \param writer writer to use.
+ *  \param text name to write.
+ *
+ */
+static void putCsvString(struct resultWriter* writer, const char* text) {
+    putBytes(writer, "\"", 1);
+    for (; *text != '\0'; text++) {
+        putBytes(writer, text, 1);
+        if (*text == '"') {
+            putBytes(writer, "\"", 1);
+        }
+    }
+    putBytes(writer, "\"", 1);
+}
+
+/**
+ *  \brief Longer words of a file, sorted by size and number of vowels.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *
+ *  \return array of entries (NULL if none), to be freed by the caller.
+ */
+static struct longWord* longWordsOf(const struct results* results,
+                                    int fileId) {
+    const struct overflowMap* map = &results->overflow[fileId];
+    struct longWord* entries;
+
+    if (map->numEntries == 0) {
+        return NULL;
+    }
+    if ((entries = malloc(sizeof(struct longWord) * map->numEntries)) == NULL) {
+        perror("Error while allocating memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    sortedLongWords(map, entries);
+    return entries;
+}
+
+/**
+ *  \brief Writing of the results of a file as a table.
+ *
+ *  \param writer writer to use.
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param filename name of the file.
+ *
+ */
+static void writeText(struct resultWriter* writer,
+                      const struct results* results, int fileId,
+                      const char* filename) {
+    const int* wordSize = fileWordSizes(results, fileId);
+    int numberWords = results->numberWords[fileId];
+    int maxWordSize = results->maxWordSize[fileId];
+    struct longWord* longWords;
+
+    putString(writer, "File name: ");
+    putString(writer, filename);
+    putString(writer, "\nTotal number of words: ");
+    putInt(writer, numberWords, 0);
+    putString(writer, "\nWord length\n   ");
+    for (int i = 1; i <= maxWordSize; i++) {
+        putInt(writer, i, 6);
+    }
+    putString(writer, "\n   ");
+    for (int i = 1; i <= maxWordSize; i++) {
+        putInt(writer, wordSize[i], 6);
+    }
+    putString(writer, "\n   ");
+    for (int i = 1; i <= maxWordSize; i++) {
+        putFixed(writer,
+                 ((float)wordSize[i] * 100.0) / (float)numberWords, 2, 6);
+    }
+
+    // Row i holds the share of the words of every size with i vowels (none
+    // has more vowels than letters)
+    for (int i = 0; i <= maxWordSize; i++) {
+        const int* vowelCount = fileVowelCounts(results, fileId, i);
+        putString(writer, "\n");
+        putInt(writer, i, 2);
+        putString(writer, " ");
+        for (int j = 1; j < i; j++) {
+            putField(writer, "", 0, 6);
+        }
+        for (int j = i > 1 ? i : 1; j <= maxWordSize; j++) {
+            putFixed(writer,
+                     wordSize[j] > 0
+                         ? (vowelCount[j] * 100.0) / (float)wordSize[j]
+                         : 0.0,
+                     1, 6);
+        }
+    }
+
+    if ((longWords = longWordsOf(results, fileId)) != NULL) {
+        putString(writer, "\nLonger words (length, vowels, count):");
+        for (int i = 0; i < results->overflow[fileId].numEntries; i++) {
+            // (fields are separated, as any of them may outgrow its width)
+            putString(writer, "\n ");
+            putInt(writer, longWords[i].size, 6);
+            putString(writer, " ");
+            putInt(writer, longWords[i].vowels, 6);
+            putString(writer, " ");
+            putInt(writer, longWords[i].count, 6);
+        }
+        free(longWords);
+    }
+    putString(writer, "\n\n");
+}
+
+/**
+ *  \brief Writing of the results of a file as a JSON object.
+ *
+ *  \param writer writer to use.
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param filename name of the file.
+ *
+ */
+static void writeJson(struct resultWriter* writer,
+                      const struct results* results, int fileId,
+                      const char* filename) {
+    const int* wordSize = fileWordSizes(results, fileId);
+    int maxWordSize = results->maxWordSize[fileId];
+    struct longWord* longWords = longWordsOf(results, fileId);
+
+    putString(writer, "{\"file\":");
+    putJsonString(writer, filename);
+    putString(writer, ",\"words\":");
+    putInt(writer, results->numberWords[fileId], 0);
+    putString(writer, ",\"maxWordSize\":");
+    putInt(writer, maxWordSize, 0);
+    putString(writer, ",\"wordSizes\":[");
+    for (int i = 1; i <= maxWordSize; i++) {
+        putString(writer, i > 1 ? "," : "");
+        putInt(writer, wordSize[i], 0);
+    }
+    putString(writer, "],\"vowelCounts\":[");
+    for (int i = 0; i <= maxWordSize; i++) {
+        const int* vowelCount = fileVowelCounts(results, fileId, i);
+        putString(writer, i > 0 ? ",[" : "[");
+        for (int j = 1; j <= maxWordSize; j++) {
+            putString(writer, j > 1 ? "," : "");
+            putInt(writer, vowelCount[j], 0);
+        }
+        putString(writer, "]");
+    }
+    putString(writer, "],\"longWords\":[");
+    for (int i = 0; longWords != NULL &&
+                    i < results->overflow[fileId].numEntries;
+         i++) {
+        putString(writer, i > 0 ? ",[" : "[");
+        putInt(writer, longWords[i].size, 0);
+        putString(writer, ",");
+        putInt(writer, longWords[i].vowels, 0);
+        putString(writer, ",");
+        putInt(writer, longWords[i].count, 0);
+        putString(writer, "]");
+    }
+    putString(writer, "]}\n");
+    free(longWords);
+}
+
+/**
+ *  \brief Writing of a (size, vowels, count) triple of a file, in the CSV or
+ * binary format.
+ *
+ *  \param writer writer to use.
+ *  \param filename name of the file.
+ *  \param size number of characters of the words.
+ *  \param vowels number of vowels of the words.
+ *  \param count number of words.
+ *
+ */
+static void writeTriple(struct resultWriter* writer, const char* filename,
+                        int size, int vowels, int count) {
+    if (writer->format == OUTPUT_BINARY) {
+        putBinaryInt(writer, size);
+        putBinaryInt(writer, vowels);
+        putBinaryInt(writer, count);
+        return;
+    }
+    putCsvString(writer, filename);
+    putString(writer, ",");
+    putInt(writer, size, 0);
+    putString(writer, ",");
+    putInt(writer, vowels, 0);
+    putString(writer, ",");
+    putInt(writer, count, 0);
+    putString(writer, "\n");
+}
+
+/**
+ *  \brief Writing of the results of a file as the (size, vowels, count)
+ * triples with words, in the CSV or binary format.
+ *
+ *  \param writer writer to use.
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param filename name of the file.
+ *
+ */
+static void writeTriples(struct resultWriter* writer,
+                         const struct results* results, int fileId,
+                         const char* filename) {
+    int maxWordSize = results->maxWordSize[fileId];
+    int numLongWords = results->overflow[fileId].numEntries;
+    struct longWord* longWords = longWordsOf(results, fileId);
+
+    if (writer->format == OUTPUT_BINARY) {
+        int numTriples = numLongWords;
+        for (int i = 0; i <= maxWordSize; i++) {
+            const int* vowelCount = fileVowelCounts(results, fileId, i);
+            for (int j = 1; j <= maxWordSize; j++) {
+                numTriples += vowelCount[j] > 0;
+            }
+        }
+        int32_t nameLength = strlen(filename);
+        putBinaryInt(writer, nameLength);
+        putBytes(writer, filename, nameLength);
+        putBinaryInt(writer, results->numberWords[fileId]);
+        putBinaryInt(writer, numTriples);
+    }
+    for (int j = 1; j <= maxWordSize; j++) {
+        for (int i = 0; i <= j; i++) {
+            int count = fileVowelCounts(results, fileId, i)[j];
+            if (count > 0) {
+                writeTriple(writer, filename, j, i, count);
+            }
+        }
+    }
+    for (int i = 0; i < numLongWords; i++) {
+        writeTriple(writer, filename, longWords[i].size, longWords[i].vowels,
+                    longWords[i].count);
+    }
+    free(longWords);
+}
+
+bool openResultWriter(struct resultWriter* writer, const char* path,
+                      enum outputFormat format) {
+    if (path == NULL) {
+        writer->file = stdout;
+    } else if ((writer->file = fopen(path, "wb")) == NULL) {
+        return false;
+    }
+    writer->format = format;
+    writer->used = 0;
+    if (format == OUTPUT_CSV) {
+        putString(writer, "file,size,vowels,count\n");
+    } else if (format == OUTPUT_BINARY) {
+        putBytes(writer, "WCR1", 4);
+    }
+    return true;
+}
+
+void writeFileResults(struct resultWriter* writer,
+                      const struct results* results, int fileId,
+                      const char* filename) {
+    switch (writer->format) {
+        case OUTPUT_TEXT:
+            writeText(writer, results, fileId, filename);
+            break;
+        case OUTPUT_JSON:
+            writeJson(writer, results, fileId, filename);
+            break;
+        default:
+            writeTriples(writer, results, fileId, filename);
+    }
+}
+
+bool closeResultWriter(struct resultWriter* writer) {
+    flushResultWriter(writer);
+    if (writer->file == stdout) {
+        return true;
+    }
+    return fclose(writer->file) == 0;
+}
@@ -0,0 +1,119 @@
+/**
+ *  \file resultWriter.h (interface file)
+ *
+ *  \brief Buffered writing of the results of every file, in the formats
+ * shared by all the 'wordCount' implementations.
+ *
+ *  The results of a file are written as a single record, as soon as they are
+ * final, in one of four formats:
+ *     \li text: the table of word sizes and vowel counts meant to be read;
+ *     \li json: a JSON object per line, with the file name, its number of
+ * words, its largest word size (up to 'dim' - 1), its word size frequencies
+ * (from size 1), its vowel count frequencies (a row per number of vowels, from
+ * 0, of frequencies from size 1) and the triples of size, vowels and count of
+ * its longer words;
+ *     \li csv: a line per file, size and number of vowels with words, after a
+ * header line;
+ *     \li binary: the magic "WCR1" followed per file by the length of its name,
+ * its name, its number of words, its number of (size, vowels, count) triples
+ * and the triples, all integers being 32-bit in the byte order of the machine.
+ *
+ *  Numbers are formatted by hand into a large buffer, which only reaches the
+ * file when full, when flushed or when closed. The json, csv and binary formats are
+ * written to a file of their own, the programs printing their messages and
+ * statistics to the standard output.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "results.h"
+
+/** \brief size (number of bytes) of the buffer of a writer. */
+#define WRITERBUFFERSIZE (64 * 1024)
+
+/**
+ *  \brief formats the results can be written in.
+ */
+enum outputFormat { OUTPUT_TEXT, OUTPUT_JSON, OUTPUT_CSV, OUTPUT_BINARY };
+
+/**
+ *  \brief structure containing the state of a writer.
+ */
+struct resultWriter {
+    /** \brief file the results are written to. */
+    FILE* file;
+
+    /** \brief format of the results. */
+    enum outputFormat format;
+
+    /** \brief text not yet written to 'file'. */
+    char buffer[WRITERBUFFERSIZE];
+
+    /** \brief number of bytes stored in 'buffer'. */
+    size_t used;
+};
+
+/**
+ *  \brief Parsing of an output format given on the command line.
+ *
+ *  \param arg argument to parse ("text", "json", "csv" or "binary").
+ *  \param format format parsed.
+ *
+ *  \return false if the argument is not a known format.
+ */
+extern bool parseOutputFormat(const char* arg, enum outputFormat* format);
+
+/**
+ *  \brief Opening of a writer, writing the header of its format.
+ *
+ *  \param writer writer to open.
+ *  \param path path to the output file (NULL for the standard output, only
+ * meant for the text format since the programs print their messages there).
+ *  \param format format of the results.
+ *
+ *  \return false if the file could not be opened.
+ */
+extern bool openResultWriter(struct resultWriter* writer, const char* path,
+                             enum outputFormat format);
+
+/**
+ *  \brief Writing of the results of a file.
+ *
+ *  \param writer writer to use.
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param filename name of the file.
+ *
+ */
+extern void writeFileResults(struct resultWriter* writer,
+                             const struct results* results, int fileId,
+                             const char* filename);
+
+/**
+ *  \brief Writing of the buffered text to the file.
+ *
+ *  Needed before anything else is written to the same file, e.g. messages to
+ * the standard output.
+ *
+ *  \param writer writer to flush.
+ *
+ */
+extern void flushResultWriter(struct resultWriter* writer);
+
+/**
+ *  \brief Flushing and closing of a writer (the standard output is left
+ * open).
+ *
+ *  \param writer writer to close.
+ *
+ *  \return false if the results could not be written.
+ */
+extern bool closeResultWriter(struct resultWriter* writer);
+
+#endif /* RESULTWRITER_H */
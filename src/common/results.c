@@ -0,0 +1,133 @@
+/**
+ *  \file results.c (implementation file)
+ *
+ *  \brief Storage of the final results of every file.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "results.h"
+
+/**
+ *  \brief Size of a section of the results block, rounded up to whole cache
+ * lines.
+ *
+ *  \param size size (number of bytes) of the contents of the section.
+ *
+ *  \return size (number of bytes) of the section.
+ */
+static size_t sectionSize(size_t size) {
+    return (size + CACHELINESIZE - 1) / CACHELINESIZE * CACHELINESIZE;
+}
+
+bool allocResults(struct results* results, int numFiles, int dim) {
+    size_t perFile = sectionSize(sizeof(int) * numFiles);
+    size_t wordSize = sectionSize(sizeof(int) * numFiles * dim);
+    size_t vowelCount = sectionSize(sizeof(int) * numFiles * dim * dim);
+    size_t overflow = sectionSize(sizeof(struct overflowMap) * numFiles);
+    size_t total = 3 * perFile + wordSize + vowelCount + overflow;
+    char* block;
+
+    if ((block = aligned_alloc(CACHELINESIZE, total)) == NULL) {
+        return false;
+    }
+    memset(block, 0, total);
+    results->numFiles = numFiles;
+    results->dim = dim;
+    results->block = block;
+    results->numberWords = (int*)block;
+    results->maxWordSize = (int*)(block + perFile);
+    results->minWordSize = (int*)(block + 2 * perFile);
+    results->wordSize = (int*)(block + 3 * perFile);
+    results->vowelCount = (int*)(block + 3 * perFile + wordSize);
+    results->overflow =
+        (struct overflowMap*)(block + 3 * perFile + wordSize + vowelCount);
+    for (int i = 0; i < numFiles; i++) {
+        results->minWordSize[i] = dim;
+    }
+    return true;
+}
+
+void freeResults(struct results* results) {
+    for (int i = 0; i < results->numFiles; i++) {
+        freeOverflow(&results->overflow[i]);
+    }
+    free(results->block);
+    results->block = NULL;
+}
+
+void addWordSizes(struct results* results, int fileId, const int* wordSize,
+                  int size) {
+    int* total = fileWordSizes(results, fileId);
+
+    for (int i = 0; i < size; i++) {
+        total[i] += wordSize[i];
+        results->numberWords[fileId] += wordSize[i];
+        if (i > results->maxWordSize[fileId] && wordSize[i] > 0) {
+            results->maxWordSize[fileId] = i;
+        }
+        if (i < results->minWordSize[fileId] && wordSize[i] > 0) {
+            results->minWordSize[fileId] = i;
+        }
+    }
+}
+
+void addVowelCounts(struct results* results, int fileId, int vowels,
+                    const int* vowelCount, int size) {
+    int* total = fileVowelCounts(results, fileId, vowels);
+
+    for (int j = 0; j < size; j++) {
+        total[j] += vowelCount[j];
+    }
+}
+
+void addLongWordResults(struct results* results, int fileId, int size,
+                        int vowels, int count) {
+    addLongWords(&results->overflow[fileId], size, vowels, count);
+    results->numberWords[fileId] += count;
+}
+
+void addHistogram(struct results* results, int fileId,
+                  const struct histogram* hist) {
+    const struct overflowMap* overflow = &hist->overflow;
+
+    addWordSizes(results, fileId, hist->wordSize, hist->maxWordSize + 1);
+    for (int i = 0; i <= hist->maxVowelCount; i++) {
+        addVowelCounts(results, fileId, i, hist->vowelCount[i],
+                       hist->maxWordSize + 1);
+    }
+    for (int i = 0; i < overflow->capacity && overflow->numEntries > 0; i++) {
+        if (overflow->entries[i].size != 0) {
+            addLongWordResults(results, fileId, overflow->entries[i].size,
+                               overflow->entries[i].vowels,
+                               overflow->entries[i].count);
+        }
+    }
+}
+
+void deriveTotals(struct results* results) {
+    for (int i = 0; i < results->numFiles; i++) {
+        const int* wordSize = fileWordSizes(results, i);
+        const struct overflowMap* overflow = &results->overflow[i];
+
+        results->numberWords[i] = 0;
+        results->maxWordSize[i] = 0;
+        results->minWordSize[i] = results->dim;
+        for (int j = 0; j < results->dim; j++) {
+            if (wordSize[j] > 0) {
+                results->numberWords[i] += wordSize[j];
+                results->maxWordSize[i] = j;
+                if (j < results->minWordSize[i]) {
+                    results->minWordSize[i] = j;
+                }
+            }
+        }
+        for (int j = 0; j < overflow->capacity && overflow->numEntries > 0;
+             j++) {
+            results->numberWords[i] += overflow->entries[j].count;
+        }
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ *  \file results.h (interface file)
+ *
+ *  \brief Storage of the final results of every file, shared by all the
+ * 'wordCount' implementations.
+ *
+ *  All the counters live in a single cache-line aligned block, allocated once
+ * for the whole run: the per-file totals first, then the word size frequencies
+ * indexed by (file, size), then the vowel count frequencies indexed by (file,
+ * vowels, size), then the sparse maps of the words too long for those arrays.
+ * Each section starts on its own cache line.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "histogram.h"
+
+/**
+ *  \brief structure containing the results of every file.
+ */
+struct results {
+    /** \brief number of files. */
+    int numFiles;
+
+    /** \brief number of word sizes (and of vowel counts) stored per file. */
+    int dim;
+
+    /** \brief number of words found in each file. */
+    int* numberWords;
+
+    /** \brief largest word size found in each file ('dim' - 1 at most, longer
+     * words are in 'overflow'). */
+    int* maxWordSize;
+
+    /** \brief smallest word size found in each file. */
+    int* minWordSize;
+
+    /** \brief number of words found per file and size ('numFiles' x 'dim'). */
+    int* wordSize;
+
+    /** \brief number of words found per file, number of vowels and size
+     * ('numFiles' x 'dim' x 'dim'). */
+    int* vowelCount;
+
+    /** \brief occurrence frequencies of the words longer than 'dim' - 1 found
+     * in each file. */
+    struct overflowMap* overflow;
+
+    /** \brief block holding all the counters. */
+    void* block;
+};
+
+/**
+ *  \brief Allocation of the results of a run.
+ *
+ *  All the counters are zeroed (the smallest word sizes are set to 'dim').
+ *
+ *  \param results results to allocate.
+ *  \param numFiles number of files.
+ *  \param dim number of word sizes (and of vowel counts) stored per file.
+ *
+ *  \return false if memory could not be allocated.
+ */
+extern bool allocResults(struct results* results, int numFiles, int dim);
+
+/**
+ *  \brief Release of the memory held by the results of a run.
+ *
+ *  \param results results to release.
+ *
+ */
+extern void freeResults(struct results* results);
+
+/**
+ *  \brief Word size frequencies of a file.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *
+ *  \return array of 'dim' counters indexed by word size.
+ */
+static inline int* fileWordSizes(const struct results* results, int fileId) {
+    return results->wordSize + (size_t)fileId * results->dim;
+}
+
+/**
+ *  \brief Vowel count frequencies of a file, for a given number of vowels.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param vowels number of vowels.
+ *
+ *  \return array of 'dim' counters indexed by word size.
+ */
+static inline int* fileVowelCounts(const struct results* results, int fileId,
+                                   int vowels) {
+    return results->vowelCount +
+           ((size_t)fileId * results->dim + vowels) * results->dim;
+}
+
+/**
+ *  \brief Accumulation of word size frequencies into the results of a file.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param wordSize number of words found whose size is equal to the index.
+ *  \param size number of entries of 'wordSize'.
+ *
+ */
+extern void addWordSizes(struct results* results, int fileId,
+                         const int* wordSize, int size);
+
+/**
+ *  \brief Accumulation of vowel count frequencies into the results of a file.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param vowels number of vowels of the words counted.
+ *  \param vowelCount number of words found with 'vowels' vowels whose size is
+ * equal to the index.
+ *  \param size number of entries of 'vowelCount'.
+ *
+ */
+extern void addVowelCounts(struct results* results, int fileId, int vowels,
+                           const int* vowelCount, int size);
+
+/**
+ *  \brief Accumulation of the occurrences of a long word into the results of a
+ * file.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param size number of characters of the words.
+ *  \param vowels number of vowels of the words.
+ *  \param count number of words found.
+ *
+ */
+extern void addLongWordResults(struct results* results, int fileId, int size,
+                               int vowels, int count);
+
+/**
+ *  \brief Accumulation of a histogram into the results of a file.
+ *
+ *  \param results results of the run.
+ *  \param fileId identifier of the file.
+ *  \param hist occurrence frequencies found in the file.
+ *
+ */
+extern void addHistogram(struct results* results, int fileId,
+                         const struct histogram* hist);
+
+/**
+ *  \brief Computation of the per-file totals (number of words, largest and
+ * smallest word sizes) from the counters alone.
+ *
+ *  Used when the counters were filled without the 'add' functions, e.g. by a
+ * collective reduction.
+ *
+ *  \param results results of the run.
+ *
+ */
+extern void deriveTotals(struct results* results);
+
+#endif /* RESULTS_H */
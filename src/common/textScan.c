@@ -0,0 +1,430 @@
+/**
+ *  \file textScan.c (implementation file)
+ *
+ *  \brief Word scanning kernel shared by all the 'wordCount' implementations.
+ *
+ *  Each 32-byte block of text is first checked for bytes with the most
+ * significant bit set. ASCII-only blocks are turned into three bitmasks
+ * (delimiters, mergers and vowels) by one of the classification kernels:
+ *     \li AVX2: one 32-byte register, classes looked up through nibble tables;
+ *     \li SSE2: two 16-byte registers, classes found by byte comparisons;
+ *     \li scalar: byte by byte, used where no SIMD instruction set is present.
+ *  The remaining blocks are processed character by character.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TEXTSCAN_X86
+#endif
+
+#include "charClass.h"
+#include "textScan.h"
+
+/** \brief number of bytes classified at once by the SIMD kernels. */
+#define SCANBLOCK 32
+
+/** \brief distance (number of bytes) from the end of a text where the search
+ * for its last word boundary starts (doubled until one is found). */
+#define BOUNDARYSTEP 4096
+
+/** \brief nibble class bits of the delimiters (AVX2 kernel). */
+#define NIB_DELIMITER 0x0F
+
+/** \brief nibble class bits of the vowels (AVX2 kernel). */
+#define NIB_VOWEL 0x30
+
+/** \brief nibble class bits of the mergers (AVX2 kernel). */
+#define NIB_MERGER 0xC0
+
+/**
+ *  \brief structure containing the classes of the bytes of a block, one bit per
+ * byte.
+ */
+struct blockMasks {
+    /** \brief bytes that are word delimiters. */
+    uint32_t delimiters;
+
+    /** \brief bytes that are word mergers. */
+    uint32_t mergers;
+
+    /** \brief bytes that are vowels. */
+    uint32_t vowels;
+};
+
+/** \brief class bitmask of each ASCII character. */
+static unsigned char asciiClass[128];
+
+/** \brief ASCII characters defined as word delimiters. */
+static char asciiDelimiters[128];
+static int numAsciiDelimiters;
+
+/** \brief ASCII characters defined as word mergers. */
+static char asciiMergers[128];
+static int numAsciiMergers;
+
+/** \brief ASCII characters defined as vowels. */
+static char asciiVowels[128];
+static int numAsciiVowels;
+
+/**
+ *  \brief Class of each ASCII character split by its low nibble (AVX2 kernel).
+ *
+ *  A byte belongs to a class when the entries of its low and high nibbles share
+ * one of the class bits. Delimiters use bits 0-3, vowels bits 4-5 and mergers
+ * bits 6-7.
+ */
+static const unsigned char nibbleLow[16] = {
+    0x82, 0x12, 0x02, 0x00, 0x00, 0x30, 0x00, 0x40,
+    0x02, 0x13, 0x05, 0x0C, 0x02, 0x0B, 0x02, 0x14};
+
+/** \brief class of each ASCII character split by its high nibble (AVX2
+ * kernel). */
+static const unsigned char nibbleHigh[16] = {
+    0x01, 0x00, 0x42, 0x04, 0x10, 0x28, 0x90, 0x28,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+/** \brief function scanning text with the kernel selected at initialization.
+ */
+static size_t (*scanFunction)(struct wordScanner*, const char*, size_t, bool,
+                              struct histogram*);
+
+/** \brief name of the kernel selected at initialization. */
+static const char* kernelName;
+
+/**
+ *  \brief Classification of an ASCII-only block, byte by byte.
+ *
+ *  \param block pointer to the first byte of the block.
+ *  \param masks classes of the bytes of the block.
+ *
+ *  \return false if the block contains non-ASCII bytes.
+ */
+static inline bool classifyBlockScalar(const char* block,
+                                       struct blockMasks* masks) {
+    const unsigned char* b = (const unsigned char*)block;
+    unsigned char high = 0;
+    for (int i = 0; i < SCANBLOCK; i++) {
+        high |= b[i];
+    }
+    if (high & 0x80) {
+        return false;
+    }
+    masks->delimiters = masks->mergers = masks->vowels = 0;
+    for (int i = 0; i < SCANBLOCK; i++) {
+        int charClass = asciiClass[b[i]];
+        masks->delimiters |= (uint32_t)((charClass & CC_DELIMITER) != 0) << i;
+        masks->mergers |= (uint32_t)((charClass & CC_MERGER) != 0) << i;
+        masks->vowels |= (uint32_t)((charClass & CC_VOWEL) != 0) << i;
+    }
+    return true;
+}
+
+#ifdef TEXTSCAN_X86
+
+/**
+ *  \brief Membership of each byte of a register in a set of characters.
+ *
+ *  \param c bytes to classify.
+ *  \param set characters of the set.
+ *  \param setSize number of characters of the set.
+ *
+ *  \return register with 0xFF in the bytes belonging to the set.
+ */
+__attribute__((target("sse2"))) static inline __m128i matchSetSSE2(
+    __m128i c, const char* set, int setSize) {
+    __m128i match = _mm_setzero_si128();
+    for (int i = 0; i < setSize; i++) {
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(c, _mm_set1_epi8(set[i])));
+    }
+    return match;
+}
+
+/**
+ *  \brief Classification of an ASCII-only block with SSE2 instructions.
+ *
+ *  \param block pointer to the first byte of the block.
+ *  \param masks classes of the bytes of the block.
+ *
+ *  \return false if the block contains non-ASCII bytes.
+ */
+__attribute__((target("sse2"))) static inline bool classifyBlockSSE2(
+    const char* block, struct blockMasks* masks) {
+    __m128i c0 = _mm_loadu_si128((const __m128i*)block);
+    __m128i c1 = _mm_loadu_si128((const __m128i*)(block + 16));
+    if (_mm_movemask_epi8(_mm_or_si128(c0, c1)) != 0) {
+        return false;
+    }
+    masks->delimiters =
+        (uint32_t)_mm_movemask_epi8(
+            matchSetSSE2(c0, asciiDelimiters, numAsciiDelimiters)) |
+        (uint32_t)_mm_movemask_epi8(
+            matchSetSSE2(c1, asciiDelimiters, numAsciiDelimiters))
+            << 16;
+    masks->mergers =
+        (uint32_t)_mm_movemask_epi8(
+            matchSetSSE2(c0, asciiMergers, numAsciiMergers)) |
+        (uint32_t)_mm_movemask_epi8(
+            matchSetSSE2(c1, asciiMergers, numAsciiMergers))
+            << 16;
+    masks->vowels =
+        (uint32_t)_mm_movemask_epi8(
+            matchSetSSE2(c0, asciiVowels, numAsciiVowels)) |
+        (uint32_t)_mm_movemask_epi8(
+            matchSetSSE2(c1, asciiVowels, numAsciiVowels))
+            << 16;
+    return true;
+}
+
+/**
+ *  \brief Classification of an ASCII-only block with AVX2 instructions.
+ *
+ *  \param block pointer to the first byte of the block.
+ *  \param masks classes of the bytes of the block.
+ *
+ *  \return false if the block contains non-ASCII bytes.
+ */
+__attribute__((target("avx2"))) static inline bool classifyBlockAVX2(
+    const char* block, struct blockMasks* masks) {
+    __m256i c = _mm256_loadu_si256((const __m256i*)block);
+    if (_mm256_movemask_epi8(c) != 0) {
+        return false;
+    }
+    __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    __m256i lowTable = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)nibbleLow));
+    __m256i highTable = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)nibbleHigh));
+    __m256i low = _mm256_and_si256(c, nibbleMask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(c, 4), nibbleMask);
+    __m256i classes = _mm256_and_si256(_mm256_shuffle_epi8(lowTable, low),
+                                       _mm256_shuffle_epi8(highTable, high));
+    __m256i zero = _mm256_setzero_si256();
+
+    masks->delimiters = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+        _mm256_and_si256(classes, _mm256_set1_epi8(NIB_DELIMITER)), zero));
+    masks->mergers = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+        _mm256_and_si256(classes, _mm256_set1_epi8((char)NIB_MERGER)), zero));
+    masks->vowels = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+        _mm256_and_si256(classes, _mm256_set1_epi8(NIB_VOWEL)), zero));
+    return true;
+}
+
+#endif /* TEXTSCAN_X86 */
+
+/**
+ *  \brief Processing of the words of a classified ASCII block.
+ *
+ *  The size and number of vowels of each word are the number of letter and
+ * vowel bits between two consecutive delimiter bits.
+ *
+ *  \param masks classes of the bytes of the block.
+ *  \param stringSize number of characters in current word.
+ *  \param numVowels number of vowels in current word.
+ *  \param hist histogram where the words found are registered.
+ *
+ */
+static inline __attribute__((always_inline)) void scanBlock(
+    const struct blockMasks* masks, int* stringSize, int* numVowels,
+    struct histogram* hist) {
+    uint32_t delimiters = masks->delimiters;
+    uint32_t letters = ~(masks->delimiters | masks->mergers);
+    uint32_t vowels = masks->vowels;
+
+    while (delimiters != 0) {
+        uint32_t before = (delimiters & -delimiters) - 1;
+        *stringSize += __builtin_popcount(letters & before);
+        *numVowels += __builtin_popcount(vowels & before);
+        letters &= ~before;
+        vowels &= ~before;
+        if (*stringSize > 0) {
+            recordWord(hist, *stringSize, *numVowels);
+            *stringSize = 0;
+            *numVowels = 0;
+        }
+        delimiters &= delimiters - 1;
+    }
+    *stringSize += __builtin_popcount(letters);
+    *numVowels += __builtin_popcount(vowels);
+}
+
+/**
+ *  \brief Processing of a portion of text with a given classification kernel.
+ *
+ *  The body is inlined in one function per kernel, so that every copy is
+ * compiled for the instruction set of its kernel.
+ *
+ */
+#define SCANTEXT_BODY(classifyBlock)                                           \
+    int stringSize = scanner->stringSize;                                      \
+    int numVowels = scanner->numVowels;                                        \
+    size_t pos = 0;                                                            \
+    struct blockMasks masks;                                                   \
+                                                                               \
+    while (pos < length) {                                                     \
+        /* Process a whole block at once (if it is ASCII-only) */              \
+        if (length - pos >= SCANBLOCK && classifyBlock(text + pos, &masks)) {  \
+            scanBlock(&masks, &stringSize, &numVowels, hist);                  \
+            pos += SCANBLOCK;                                                  \
+            continue;                                                          \
+        }                                                                      \
+                                                                               \
+        /* Process the block character by character */                         \
+        size_t blockEnd = pos + SCANBLOCK < length ? pos + SCANBLOCK : length; \
+        while (pos < blockEnd) {                                               \
+            int charClass;                                                     \
+            if (!atEnd && utf8Length[(unsigned char)text[pos]] > length - pos) \
+                goto done;                                                     \
+            pos += classifyChar(text + pos, length - pos, &charClass);         \
+                                                                               \
+            /* Check if character is a delimiter */                            \
+            if (charClass & CC_DELIMITER) {                                    \
+                if (stringSize > 0) {                                          \
+                    recordWord(hist, stringSize, numVowels);                   \
+                    stringSize = 0;                                            \
+                    numVowels = 0;                                             \
+                }                                                              \
+                continue;                                                      \
+            }                                                                  \
+                                                                               \
+            /* Increment word size and number of vowels (if applicable) */     \
+            stringSize += !(charClass & CC_MERGER);                            \
+            numVowels += (charClass & CC_VOWEL) != 0;                          \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    done:                                                                      \
+    scanner->stringSize = stringSize;                                          \
+    scanner->numVowels = numVowels;                                            \
+    return pos;
+
+/** \brief processing of a portion of text with the scalar kernel. */
+static size_t scanTextScalar(struct wordScanner* scanner, const char* text,
+                             size_t length, bool atEnd,
+                             struct histogram* hist) {
+    SCANTEXT_BODY(classifyBlockScalar)
+}
+
+#ifdef TEXTSCAN_X86
+
+/** \brief processing of a portion of text with the SSE2 kernel. */
+__attribute__((target("sse2"))) static size_t scanTextSSE2(
+    struct wordScanner* scanner, const char* text, size_t length, bool atEnd,
+    struct histogram* hist) {
+    SCANTEXT_BODY(classifyBlockSSE2)
+}
+
+/** \brief processing of a portion of text with the AVX2 kernel. */
+__attribute__((target("avx2,popcnt"))) static size_t scanTextAVX2(
+    struct wordScanner* scanner, const char* text, size_t length, bool atEnd,
+    struct histogram* hist) {
+    SCANTEXT_BODY(classifyBlockAVX2)
+}
+
+#endif /* TEXTSCAN_X86 */
+
+/**
+ *  \brief Verification of the nibble tables of the AVX2 kernel.
+ *
+ *  \return true if the tables agree with the classification tables for every
+ * ASCII character.
+ */
+static bool nibbleTablesMatch(void) {
+    for (int b = 0; b < 128; b++) {
+        int classes = nibbleLow[b & 0x0F] & nibbleHigh[b >> 4];
+        int expected = 0;
+        if (asciiClass[b] & CC_DELIMITER) {
+            expected |= NIB_DELIMITER;
+        }
+        if (asciiClass[b] & CC_MERGER) {
+            expected |= NIB_MERGER;
+        }
+        if (asciiClass[b] & CC_VOWEL) {
+            expected |= NIB_VOWEL;
+        }
+        if (((classes & NIB_DELIMITER) != 0) !=
+                ((expected & NIB_DELIMITER) != 0) ||
+            ((classes & NIB_MERGER) != 0) != ((expected & NIB_MERGER) != 0) ||
+            ((classes & NIB_VOWEL) != 0) != ((expected & NIB_VOWEL) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void initTextScan(void) {
+    initCharClasses();
+
+    // Gather the classes of the ASCII characters
+    numAsciiDelimiters = numAsciiMergers = numAsciiVowels = 0;
+    for (int b = 0; b < 128; b++) {
+        asciiClass[b] = codePointClass(b);
+        if (asciiClass[b] & CC_DELIMITER) {
+            asciiDelimiters[numAsciiDelimiters++] = b;
+        }
+        if (asciiClass[b] & CC_MERGER) {
+            asciiMergers[numAsciiMergers++] = b;
+        }
+        if (asciiClass[b] & CC_VOWEL) {
+            asciiVowels[numAsciiVowels++] = b;
+        }
+    }
+
+    // Select the kernel supported by the processor
+    scanFunction = scanTextScalar;
+    kernelName = "scalar";
+#ifdef TEXTSCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && nibbleTablesMatch()) {
+        scanFunction = scanTextAVX2;
+        kernelName = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        scanFunction = scanTextSSE2;
+        kernelName = "sse2";
+    }
+#endif
+}
+
+const char* textScanKernel(void) { return kernelName; }
+
+size_t scanText(struct wordScanner* scanner, const char* text, size_t length,
+                bool atEnd, struct histogram* hist) {
+    return scanFunction(scanner, text, length, atEnd, hist);
+}
+
+size_t nextWordBoundary(const char* text, size_t length, size_t pos) {
+    int charClass;
+
+    if (pos == 0 || pos >= length) {
+        return pos < length ? pos : length;
+    }
+
+    // Skip the continuation bytes of a character cut short
+    while (pos < length && ((unsigned char)text[pos] & 0xC0) == 0x80) {
+        pos++;
+    }
+
+    // Stop right after the first delimiter found
+    while (pos < length) {
+        pos += classifyChar(text + pos, length - pos, &charClass);
+        if (charClass & CC_DELIMITER) {
+            break;
+        }
+    }
+    return pos;
+}
+
+size_t lastWordBoundary(const char* text, size_t length) {
+    for (size_t back = BOUNDARYSTEP;; back *= 2) {
+        size_t pos = back < length ? length - back : 0;
+        size_t cut = nextWordBoundary(text, length, pos);
+        if (cut < length || pos == 0) {
+            return cut;
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ *  \file textScan.h (interface file)
+ *
+ *  \brief Word scanning kernel shared by all the 'wordCount' implementations.
+ *
+ *  Text is processed in blocks of 32 bytes. Blocks made only of ASCII
+ * characters are classified at once by a SIMD kernel (AVX2 or SSE2, chosen at
+ * run time through CPUID) that produces delimiter, merger and vowel bitmasks;
+ * word sizes and vowel counts are then obtained by counting the bits between
+ * consecutive delimiters. Blocks containing multi-byte characters fall back to
+ * the scalar UTF-8 path of 'charClass.h'.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef TEXTSCAN_H
+#define TEXTSCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "histogram.h"
+
+/**
+ *  \brief structure containing the state of the word under construction,
+ * carried between consecutive portions of the same text.
+ */
+struct wordScanner {
+    /** \brief number of characters in current word. */
+    int stringSize;
+
+    /** \brief number of vowels in current word. */
+    int numVowels;
+};
+
+/**
+ *  \brief Initialization of the scanning kernel.
+ *
+ *  Builds the character classification tables and selects the SIMD kernel
+ * supported by the processor. Must be called once, before any text is scanned.
+ *
+ */
+extern void initTextScan(void);
+
+/**
+ *  \brief Name of the scanning kernel in use.
+ *
+ *  \return "avx2", "sse2" or "scalar".
+ */
+extern const char* textScanKernel(void);
+
+/**
+ *  \brief Reset of the state of a word scanner.
+ *
+ *  \param scanner scanner to reset.
+ *
+ */
+static inline void initScanner(struct wordScanner* scanner) {
+    scanner->stringSize = 0;
+    scanner->numVowels = 0;
+}
+
+/**
+ *  \brief Processing of a portion of text.
+ *
+ *  Every word closed by a delimiter is registered in 'hist'; the word still
+ * open at the end of the text is kept in 'scanner'.
+ *
+ *  \param scanner state of the word under construction.
+ *  \param text portion of text to process.
+ *  \param length number of bytes of 'text'.
+ *  \param atEnd whether 'text' ends the input (a character cut short by the
+ * end of 'text' is then processed as is, otherwise it is left unconsumed).
+ *  \param hist histogram where the words found are registered.
+ *
+ *  \return number of bytes consumed.
+ */
+extern size_t scanText(struct wordScanner* scanner, const char* text,
+                       size_t length, bool atEnd, struct histogram* hist);
+
+/**
+ *  \brief Position of the first word boundary after a given position.
+ *
+ *  A word boundary is the position right after a delimiter (or the start of
+ * the text). Positions inside a multi-byte character are first moved to the
+ * start of the next character, so every caller cutting the same text at the
+ * same position finds the same boundary.
+ *
+ *  \param text text to cut.
+ *  \param length number of bytes of 'text'.
+ *  \param pos position from where the boundary is searched.
+ *
+ *  \return position of the boundary ('length' if there is none).
+ */
+extern size_t nextWordBoundary(const char* text, size_t length, size_t pos);
+
+/**
+ *  \brief Position of a word boundary close to the end of a text, e.g. to cut
+ * a full buffer keeping its last word for the next one.
+ *
+ *  \param text text to cut (starting at a word boundary).
+ *  \param length number of bytes of 'text'.
+ *
+ *  \return position of the boundary (0 if the text holds no boundary).
+ */
+extern size_t lastWordBoundary(const char* text, size_t length);
+
+/**
+ *  \brief Registration of the word under construction (if any).
+ *
+ *  \param scanner state of the word under construction.
+ *  \param hist histogram where the word is registered.
+ *
+ */
+static inline void endWord(struct wordScanner* scanner,
+                           struct histogram* hist) {
+    if (scanner->stringSize > 0) {
+        recordWord(hist, scanner->stringSize, scanner->numVowels);
+    }
+    scanner->stringSize = 0;
+    scanner->numVowels = 0;
+}
+
+#endif /* TEXTSCAN_H */
@@ -0,0 +1,141 @@
+/**
+ *  \file trace.c (implementation file)
+ *
+ *  \brief Timeline of the activity of every thread, written in the Chrome
+ * trace format.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+/** \brief number of events of a buffer when its first event is recorded. */
+#define TRACEBUFFERSIZE 1024
+
+/** \brief largest number of bytes of a formatted event. */
+#define MAXEVENTSIZE 160
+
+_Thread_local struct traceBuffer* ownTrace = NULL;
+
+double traceOrigin = 0;
+
+/** \brief buffers of all threads (NULL if disabled). */
+static struct traceBuffer* allTraces = NULL;
+
+/** \brief number of entries of 'allTraces'. */
+static int numTraces = 0;
+
+void recordTraceEvent(const char* name, double start, double end) {
+    struct traceBuffer* buffer = ownTrace;
+
+    // Grow by doubling, dropping the event if no memory is left
+    if (buffer->numEvents == buffer->capacity) {
+        size_t capacity =
+            buffer->capacity > 0 ? 2 * buffer->capacity : TRACEBUFFERSIZE;
+        struct traceEvent* events =
+            realloc(buffer->events, sizeof(struct traceEvent) * capacity);
+        if (events == NULL) {
+            buffer->numDropped++;
+            return;
+        }
+        buffer->events = events;
+        buffer->capacity = capacity;
+    }
+    buffer->events[buffer->numEvents].name = name;
+    buffer->events[buffer->numEvents].start = start;
+    buffer->events[buffer->numEvents].end = end;
+    buffer->numEvents++;
+}
+
+bool initTrace(int numThreads) {
+    size_t size = sizeof(struct traceBuffer) * numThreads;
+
+    if ((allTraces = aligned_alloc(CACHELINESIZE, size)) == NULL) {
+        return false;
+    }
+    memset(allTraces, 0, size);
+    numTraces = numThreads;
+    traceOrigin = 0;
+    traceOrigin = traceClock();
+    return true;
+}
+
+void bindTraceThread(int threadId, const char* kind) {
+    if (allTraces != NULL) {
+        ownTrace = &allTraces[threadId];
+        snprintf(ownTrace->label, sizeof(ownTrace->label), "%s %d", kind,
+                 threadId);
+    }
+}
+
+char* formatTrace(int pid, const char* label, size_t* len) {
+    size_t capacity = MAXEVENTSIZE;
+    char* text;
+    char* next;
+
+    for (int i = 0; i < numTraces; i++) {
+        capacity += MAXEVENTSIZE * (allTraces[i].numEvents + 1);
+    }
+    if ((text = malloc(capacity)) == NULL) {
+        return NULL;
+    }
+
+    // Name the process and the threads bound, then list their spans (in
+    // microseconds)
+    next = text;
+    next += sprintf(next,
+                    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                    "\"args\":{\"name\":\"%s\"}}",
+                    pid, label);
+    for (int i = 0; i < numTraces; i++) {
+        const struct traceBuffer* buffer = &allTraces[i];
+        if (buffer->label[0] == '\0') {
+            continue;
+        }
+        next += sprintf(next,
+                        ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                        "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                        pid, i, buffer->label);
+        for (size_t j = 0; j < buffer->numEvents; j++) {
+            const struct traceEvent* event = &buffer->events[j];
+            next += sprintf(next,
+                            ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,"
+                            "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                            event->name, pid, i, event->start * 1e6,
+                            (event->end - event->start) * 1e6);
+        }
+        if (buffer->numDropped > 0) {
+            fprintf(stderr, "Trace: %zu events of %s dropped.\n",
+                    buffer->numDropped, buffer->label);
+        }
+    }
+    *len = next - text;
+    return text;
+}
+
+bool writeTrace(const char* path, const char* events, size_t len) {
+    FILE* file;
+    bool written;
+
+    if ((file = fopen(path, "w")) == NULL) {
+        return false;
+    }
+    written = fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n",
+                    file) != EOF &&
+              fwrite(events, 1, len, file) == len &&
+              fputs("\n]}\n", file) != EOF;
+    return fclose(file) == 0 && written;
+}
+
+void freeTrace(void) {
+    for (int i = 0; i < numTraces; i++) {
+        free(allTraces[i].events);
+    }
+    free(allTraces);
+    allTraces = NULL;
+    numTraces = 0;
+}
@@ -0,0 +1,181 @@
+/**
+ *  \file trace.h (interface file)
+ *
+ *  \brief Timeline of the activity of every thread, written in the Chrome
+ * trace format (read by chrome://tracing and Perfetto).
+ *
+ *  When enabled, every traced thread owns a buffer of events, each being a
+ * named span of time (fetching a text chunk, scanning it, merging results,
+ * waiting idle). Only its thread appends to a buffer, so no lock is taken.
+ * Times are read from the monotonic clock, relative to the time tracing
+ * started. At exit the events are formatted as JSON objects, the process
+ * identifier being e.g. the MPI rank and the thread identifier the one given
+ * to the thread. When disabled, a thread has no buffer and the only cost left
+ * is a test of a null thread-local pointer.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "histogram.h"
+
+/**
+ *  \brief structure containing a span of time of a thread.
+ */
+struct traceEvent {
+    /** \brief name of the activity (a string literal). */
+    const char* name;
+
+    /** \brief start of the span (seconds since tracing started). */
+    double start;
+
+    /** \brief end of the span (seconds since tracing started). */
+    double end;
+};
+
+/**
+ *  \brief structure containing the events of a thread.
+ */
+struct traceBuffer {
+    /** \brief events recorded. */
+    struct traceEvent* events;
+
+    /** \brief number of events recorded. */
+    size_t numEvents;
+
+    /** \brief number of entries of 'events'. */
+    size_t capacity;
+
+    /** \brief number of events lost for lack of memory. */
+    size_t numDropped;
+
+    /** \brief name of the thread. */
+    char label[32];
+} __attribute__((aligned(CACHELINESIZE)));
+
+/** \brief buffer of the calling thread (NULL if disabled or not traced). */
+extern _Thread_local struct traceBuffer* ownTrace;
+
+/** \brief time (monotonic clock, seconds) tracing started. */
+extern double traceOrigin;
+
+/**
+ *  \brief Current time, relative to the start of tracing.
+ *
+ *  \return time (seconds).
+ */
+static inline double traceClock(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9 - traceOrigin;
+}
+
+/**
+ *  \brief Recording of an event of the calling thread (which must be traced).
+ *
+ *  \param name name of the activity (a string literal).
+ *  \param start start of the span.
+ *  \param end end of the span.
+ *
+ */
+extern void recordTraceEvent(const char* name, double start, double end);
+
+/**
+ *  \brief Start of a span of the calling thread.
+ *
+ *  \return current time (0 if the thread is not traced).
+ */
+static inline double traceMark(void) {
+    return ownTrace != NULL ? traceClock() : 0;
+}
+
+/**
+ *  \brief Recording of a span of the calling thread ending now.
+ *
+ *  \param name name of the activity (a string literal).
+ *  \param start start of the span, given by 'traceMark'.
+ *
+ */
+static inline void traceSpan(const char* name, double start) {
+    if (ownTrace != NULL) {
+        recordTraceEvent(name, start, traceClock());
+    }
+}
+
+/**
+ *  \brief Recording of a span of the calling thread ending now, the next one
+ * starting at once.
+ *
+ *  \param name name of the activity (a string literal).
+ *  \param mark start of the span, moved to the current time.
+ *
+ */
+static inline void traceLap(const char* name, double* mark) {
+    if (ownTrace != NULL) {
+        double now = traceClock();
+        recordTraceEvent(name, *mark, now);
+        *mark = now;
+    }
+}
+
+/**
+ *  \brief Allocation of the (empty) buffers of all threads, tracing starting
+ * now.
+ *
+ *  \param numThreads number of threads traced.
+ *
+ *  \return false if memory could not be allocated.
+ */
+extern bool initTrace(int numThreads);
+
+/**
+ *  \brief Binding of the calling thread to a buffer.
+ *
+ *  Does nothing unless the buffers were allocated.
+ *
+ *  \param threadId identifier of the thread in the trace.
+ *  \param kind kind of thread, the name of the thread being followed by its
+ * identifier.
+ *
+ */
+extern void bindTraceThread(int threadId, const char* kind);
+
+/**
+ *  \brief Formatting of the events of all threads as comma-separated JSON
+ * objects, preceded by the names of the process and of its threads.
+ *
+ *  \param pid process identifier in the trace.
+ *  \param label name of the process.
+ *  \param len number of bytes of the text.
+ *
+ *  \return text (to be freed by the caller), NULL if memory could not be
+ * allocated.
+ */
+extern char* formatTrace(int pid, const char* label, size_t* len);
+
+/**
+ *  \brief Writing of a trace file.
+ *
+ *  \param path path to the file.
+ *  \param events events, as given by 'formatTrace' (several may be joined by
+ * commas).
+ *  \param len number of bytes of 'events'.
+ *
+ *  \return false if the file could not be written.
+ */
+extern bool writeTrace(const char* path, const char* events, size_t len);
+
+/**
+ *  \brief Release of the buffers of all threads.
+ *
+ */
+extern void freeTrace(void);
+
+#endif /* TRACE_H */
@@ -0,0 +1,229 @@
+/**
+ *  \file rankThreads.c (implementation file)
+ *
+ *  \brief Pool of worker threads scanning the text read by an MPI rank.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/textScan.h"
+#include "../common/trace.h"
+#include "rankThreads.h"
+
+/**
+ *  \brief structure containing the arguments of a thread.
+ */
+struct rankThread {
+    /** \brief pool of the thread. */
+    struct rankThreads* pool;
+
+    /** \brief internal thread identifier. */
+    int id;
+};
+
+/**
+ *  \brief Addition of the histogram of a thread to the results of the rank.
+ *
+ *  Called with the lock held.
+ *
+ *  \param pool pool of the rank.
+ *  \param fileId identifier of the file of the histogram (-1 if empty).
+ *  \param hist histogram, cleared afterwards.
+ */
+static void saveHistogram(struct rankThreads* pool, int fileId,
+                          struct histogram* hist) {
+    if (fileId != -1) {
+        addHistogram(pool->results, fileId, hist);
+        clearHistogram(hist);
+    }
+}
+
+/**
+ *  \brief Function rankThread.
+ *
+ *  Claims slices of the oldest block, scanning them into its own histogram,
+ * until the main thread has no more text.
+ *
+ *  \param par pointer to the arguments of the thread.
+ */
+static void* rankThread(void* par) {
+    struct rankThread* self = par;
+    struct rankThreads* pool = self->pool;
+    struct wordScanner scanner;
+    struct histogram* hist;
+    int fileId = -1;
+
+    if ((hist = arenaAlloc(pool->arena, sizeof(struct histogram))) == NULL) {
+        pool->status[self->id] = EXIT_FAILURE;
+        perror("Error on allocating the histogram of a rank thread.\n");
+        pthread_exit(&pool->status[self->id]);
+    }
+    initHistogram(hist);
+    initScanner(&scanner);
+    bindTraceThread(self->id + 1, "thread");
+    double traced = traceMark();
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        // The block claimed from may still be scanned after the ring wrapped
+        // around, so it needs text left to claim
+        struct textBlock* block = &pool->blocks[pool->claimed];
+        double idle = traceMark();
+        bool waited = false;
+        while (!(block->filled && block->next < block->size) && !pool->done) {
+            pthread_cond_wait(&pool->blockFilled, &pool->lock);
+            block = &pool->blocks[pool->claimed];
+            waited = true;
+        }
+        if (waited) {
+            traceSpan("idle", idle);
+        }
+        if (!(block->filled && block->next < block->size)) {
+            break;
+        }
+
+        // Claim a slice ending right after a delimiter, moving on to the next
+        // block once this one is all claimed
+        size_t start = block->next;
+        size_t end = start + TEXTSLICESIZE < block->size
+                         ? nextWordBoundary(block->data, block->size,
+                                            start + TEXTSLICESIZE)
+                         : block->size;
+        block->next = end;
+        block->pending++;
+        if (end == block->size) {
+            pool->claimed = (pool->claimed + 1) % NUMTEXTBLOCKS;
+        }
+        if (block->fileId != fileId) {
+            saveHistogram(pool, fileId, hist);
+            fileId = block->fileId;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        traceLap("fetch", &traced);
+
+        scanText(&scanner, block->data + start, end - start, true, hist);
+        endWord(&scanner, hist);
+        traceLap("scan", &traced);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->numSlices++;
+        if (--block->pending == 0 && block->next == block->size) {
+            block->filled = false;
+            pthread_cond_signal(&pool->blockEmptied);
+        }
+    }
+    saveHistogram(pool, fileId, hist);
+    pthread_mutex_unlock(&pool->lock);
+    traceLap("merge", &traced);
+    freeHistogram(hist);
+
+    pool->status[self->id] = EXIT_SUCCESS;
+    pthread_exit(&pool->status[self->id]);
+}
+
+bool startRankThreads(struct rankThreads* pool, int numThreads,
+                      struct results* results, struct arena* arena) {
+    struct rankThread* args;
+
+    pool->results = results;
+    pool->arena = arena;
+    pool->numThreads = numThreads;
+    pool->claimed = 0;
+    pool->refilled = 0;
+    pool->done = false;
+    pool->numSlices = 0;
+    for (int i = 0; i < NUMTEXTBLOCKS; i++) {
+        memset(&pool->blocks[i], 0, sizeof(struct textBlock));
+        if (!growTextBlock(pool, &pool->blocks[i], TEXTBLOCKSIZE)) {
+            return false;
+        }
+    }
+    pool->threads = arenaAlloc(arena, sizeof(pthread_t) * numThreads);
+    pool->status = arenaAlloc(arena, sizeof(int) * numThreads);
+    args = arenaAlloc(arena, sizeof(struct rankThread) * numThreads);
+    if (pool->threads == NULL || pool->status == NULL || args == NULL) {
+        return false;
+    }
+    if (pthread_mutex_init(&pool->lock, NULL) != 0 ||
+        pthread_cond_init(&pool->blockFilled, NULL) != 0 ||
+        pthread_cond_init(&pool->blockEmptied, NULL) != 0) {
+        return false;
+    }
+
+    for (int i = 0; i < numThreads; i++) {
+        args[i].pool = pool;
+        args[i].id = i;
+        if (pthread_create(&pool->threads[i], NULL, rankThread, &args[i]) !=
+            0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct textBlock* emptyTextBlock(struct rankThreads* pool) {
+    struct textBlock* block = &pool->blocks[pool->refilled];
+
+    pthread_mutex_lock(&pool->lock);
+    while (block->filled) {
+        pthread_cond_wait(&pool->blockEmptied, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    block->size = 0;
+    return block;
+}
+
+bool growTextBlock(struct rankThreads* pool, struct textBlock* block,
+                   size_t capacity) {
+    char* data;
+
+    // The old text belongs to the arena, so it is simply left behind
+    if (capacity <= block->capacity) {
+        return true;
+    }
+    if ((data = arenaAlloc(pool->arena, capacity)) == NULL) {
+        return false;
+    }
+    memcpy(data, block->data, block->size);
+    block->data = data;
+    block->capacity = capacity;
+    return true;
+}
+
+void publishTextBlock(struct rankThreads* pool, struct textBlock* block) {
+    if (block->size == 0) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    block->next = 0;
+    block->pending = 0;
+    block->filled = true;
+    pool->refilled = (pool->refilled + 1) % NUMTEXTBLOCKS;
+    pthread_cond_broadcast(&pool->blockFilled);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+bool stopRankThreads(struct rankThreads* pool) {
+    bool stopped = true;
+    int* status;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->done = true;
+    pthread_cond_broadcast(&pool->blockFilled);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->numThreads; i++) {
+        if (pthread_join(pool->threads[i], (void**)&status) != 0 ||
+            *status != EXIT_SUCCESS) {
+            stopped = false;
+        }
+    }
+    pthread_cond_destroy(&pool->blockFilled);
+    pthread_cond_destroy(&pool->blockEmptied);
+    pthread_mutex_destroy(&pool->lock);
+    return stopped;
+}
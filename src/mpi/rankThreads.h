@@ -0,0 +1,165 @@
+/**
+ *  \file rankThreads.h (interface file)
+ *
+ *  \brief Pool of worker threads scanning the text read by an MPI rank.
+ *
+ *  The main thread of the rank, the only one making MPI calls, reads its share
+ * of the files into a small ring of text blocks, each one ending right after a
+ * delimiter. The worker threads claim slices of the oldest block through a
+ * monitor (a lock and two condition variables), scan them into histograms of
+ * their own and add a histogram to the results of the rank whenever they move
+ * on to another file. A block is handed back to the main thread once all its
+ * slices are scanned.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef RANKTHREADS_H
+#define RANKTHREADS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../common/arena.h"
+#include "../common/results.h"
+
+/** \brief number of text blocks of a pool (one is filled while the other is
+ * scanned). */
+#define NUMTEXTBLOCKS 2
+
+/** \brief initial size (number of bytes) of a text block. */
+#define TEXTBLOCKSIZE (4 * 1024 * 1024)
+
+/** \brief size (number of bytes) of the slices claimed by the threads. */
+#define TEXTSLICESIZE (64 * 1024)
+
+/**
+ *  \brief structure containing a block of text read by the main thread.
+ */
+struct textBlock {
+    /** \brief text (not null-terminated). */
+    char* data;
+
+    /** \brief number of bytes of 'data'. */
+    size_t capacity;
+
+    /** \brief number of bytes of text handed to the threads. */
+    size_t size;
+
+    /** \brief identifier of the file the text belongs to. */
+    int fileId;
+
+    /** \brief offset of the first byte not yet claimed. */
+    size_t next;
+
+    /** \brief number of slices claimed and not yet scanned. */
+    int pending;
+
+    /** \brief whether the block is handed to the threads. */
+    bool filled;
+};
+
+/**
+ *  \brief structure containing the pool of threads of a rank.
+ */
+struct rankThreads {
+    /** \brief lock protecting the blocks and the results. */
+    pthread_mutex_t lock;
+
+    /** \brief signaled when a block is handed to the threads. */
+    pthread_cond_t blockFilled;
+
+    /** \brief signaled when a block is handed back to the main thread. */
+    pthread_cond_t blockEmptied;
+
+    /** \brief ring of text blocks. */
+    struct textBlock blocks[NUMTEXTBLOCKS];
+
+    /** \brief block the threads claim slices from. */
+    int claimed;
+
+    /** \brief block the main thread fills next. */
+    int refilled;
+
+    /** \brief whether the main thread has no more text. */
+    bool done;
+
+    /** \brief results of the rank. */
+    struct results* results;
+
+    /** \brief arena the blocks and histograms are allocated from. */
+    struct arena* arena;
+
+    /** \brief number of threads. */
+    int numThreads;
+
+    /** \brief threads. */
+    pthread_t* threads;
+
+    /** \brief return status of every thread. */
+    int* status;
+
+    /** \brief number of slices scanned. */
+    long numSlices;
+};
+
+/**
+ *  \brief Start of the threads of a rank.
+ *
+ *  \param pool pool to start.
+ *  \param numThreads number of threads.
+ *  \param results results of the rank the threads add their histograms to.
+ *  \param arena arena the blocks and histograms are allocated from.
+ *
+ *  \return false if the pool could not be started.
+ */
+extern bool startRankThreads(struct rankThreads* pool, int numThreads,
+                             struct results* results, struct arena* arena);
+
+/**
+ *  \brief Retrieval of the next block to fill (by the main thread).
+ *
+ *  Waits until the threads are done with the block.
+ *
+ *  \param pool pool of the rank.
+ *
+ *  \return empty block.
+ */
+extern struct textBlock* emptyTextBlock(struct rankThreads* pool);
+
+/**
+ *  \brief Growth of a block, keeping its text.
+ *
+ *  \param pool pool of the rank.
+ *  \param block block not handed to the threads.
+ *  \param capacity smallest number of bytes needed.
+ *
+ *  \return false if memory could not be allocated.
+ */
+extern bool growTextBlock(struct rankThreads* pool, struct textBlock* block,
+                          size_t capacity);
+
+/**
+ *  \brief Handover of a filled block to the threads.
+ *
+ *  The text must end right after a delimiter or at the end of a file share.
+ * An empty block is kept by the main thread.
+ *
+ *  \param pool pool of the rank.
+ *  \param block block filled.
+ *
+ */
+extern void publishTextBlock(struct rankThreads* pool,
+                             struct textBlock* block);
+
+/**
+ *  \brief Stop of the threads, once all the blocks handed over are scanned.
+ *
+ *  \param pool pool of the rank.
+ *
+ *  \return false if a thread failed.
+ */
+extern bool stopRankThreads(struct rankThreads* pool);
+
+#endif /* RANKTHREADS_H */
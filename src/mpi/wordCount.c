@@ -10,236 +10,839 @@
 #include <time.h>
 #include <unistd.h>
 
-/** \brief maximum size possible for a word. */
-#define MAXSIZE 50
-
-/** \brief maximum size (number of bytes) possible for a character. */
-#define MAXCHARSIZE 6
+#include "../common/arena.h"
+#include "../common/bufferPool.h"
+#include "../common/inputMap.h"
+#include "../common/results.h"
+#include "../common/resultWriter.h"
+#include "../common/textScan.h"
+#include "../common/trace.h"
+#include "rankThreads.h"
 
 /** \brief memory space (number of bytes) available for words under processing.
  */
 #define BUFFERSIZE 1000
 
-/** \brief auxiliary variable for internal calculations. */
-#define BILLION 1000000000.0
+/** \brief memory space (number of bytes) of the pooled text chunk buffers (a
+ * chunk only exceeds it when it ends with a very long word). */
+#define CHUNKBUFFERSIZE (2 * BUFFERSIZE)
+
+/** \brief largest number of distinct long words in a chunk cut by
+ * 'getTextChunk'. */
+#define MAXLONGWORDS (BUFFERSIZE / HISTSIZE + 1)
+
+/** \brief number of ints of the header of a packed result (file, largest word
+ * size + 1, largest vowel count + 1 and number of long words). */
+#define RESULTHEADER 4
+
+/** \brief largest number of ints of a packed result: the header, the word
+ * sizes, a row of word sizes per vowel count and the long word triples. */
+#define RESULTSIZE \
+    (RESULTHEADER + HISTSIZE + HISTSIZE * HISTSIZE + 3 * MAXLONGWORDS)
 
-/** \brief array containing all the characters defined as word delimiters. */
-char delimiters[25][MAXCHARSIZE] = {
-    " ", "-", "–", "—",  ".",  ",",  ":",  ";", "(", ")", "[", "]", "{",
-    "}", "?", "!", "\n", "\t", "\r", "\"", "“", "”", "«", "»", "…"};
+/** \brief memory space (number of bytes) of the buffer each rank reads its
+ * byte ranges into with MPI-IO. */
+#define IOCHUNKSIZE (1024 * 1024)
 
-/** \brief array containing all the characters defined as word mergers. */
-char mergers[7][MAXCHARSIZE] = {"‘", "’", "´", "`", "'", "ü", "Ü"};
+/** \brief offset standing for a word boundary not found. */
+#define NOBOUNDARY LLONG_MAX
 
-/** \brief array containing all the possible vowels. */
-char vowels[48][MAXCHARSIZE] = {
-    "a", "e", "i", "o", "u", "A", "E", "I", "O", "U", "á", "à",
-    "ã", "â", "ä", "é", "è", "ẽ", "ê", "ë", "Á", "À", "Ã", "Â",
-    "Ä", "É", "È", "Ẽ", "Ê", "Ë", "ó", "ò", "õ", "ô", "ö", "Ó",
-    "Ò", "Õ", "Ô", "Ö", "í", "ì", "Í", "Ì", "ú", "ù", "Ú", "Ù"};
+/** \brief default number of chunks a worker is sent ahead of its results. */
+#define CHUNKSINFLIGHT 2
+
+/** \brief tags of the chunk headers (file and size) and of the chunk texts. */
+#define HEADERTAG 0
+#define TEXTTAG 1
+
+/** \brief auxiliary variable for internal calculations. */
+#define BILLION 1000000000.0
 
 // Declare useful variables
 
 struct timespec t0, t1;  // time variables to calculate execution time
 
-int** wordSizeResults;
-int*** vowelCountResults;
-int* numberWordsResults;
-int* maximumSizeWordResults;
+struct results results;
+
+// Writer of the results (root only), the first file not written yet and the
+// chunks of every file whose results are still on their way
+struct resultWriter writer;
+int nextFileOut = 0;
+int* pendingChunks;
+
+// Memory held for the whole run, and buffers recycled for every message
+struct arena runArena;
+struct bufferPool chunkPool;
+struct bufferPool resultPool;
+
+// Buffers for the rare requests too large for the pools (grown on demand)
+struct largeBuffer {
+    void* data;
+    size_t capacity;
+} largeResult;
+
+// Chunk sent ahead to a worker (the root keeps one per worker and slot, a
+// worker one per slot)
+struct chunkSlot {
+    int header[2];
+    char* text;
+    MPI_Request requests[2];
+    struct largeBuffer large;
+};
+struct chunkSlot* chunkSlots;
+int chunksInFlight = CHUNKSINFLIGHT;
+int* nextSlot;
+
+// Time a rank spent waiting for its next piece of work
+double idleTime = 0;
+
+// Whether the root scans chunks itself in between dispatch duties, and how
+// many it scanned
+bool rootWorks = false;
+long numRootChunks = 0;
+
+// Threads scanning the text read by the rank (none unless hybrid)
+int numThreads = 0;
+struct rankThreads rankPool;
+
+// Traffic of the root, to measure the messages and bytes per chunk
+long numChunks = 0;
+long numMessages = 0;
+long long numBytes = 0;
 
-char tmpWord[MAXSIZE] = "";
 int currentFileIdx = 0;
-char symbol;
-char completeSymbol[MAXCHARSIZE];  // buffer for complex character
-                                   // construction
-int ones;
-bool incrementFileIdx;
+size_t currentOffset = 0;
 
 int filesSize;
-FILE** files;
+struct inputMap* inputs;
 char** filenames;
 
 int totalNumWorkers = 0;
 
-int maxWordSize = 0;
-int maxVowelCount = 0;
+// Whether the ranks keep their results until a single reduction at the end
+bool reduceAtEnd = false;
+
+// File the timeline of every rank is written to by the root (NULL if not
+// traced)
+const char* tracePath = NULL;
+
 int fileId = -1;
 
-bool getTextChunk(char* textChunk, int* fileId) {
-    bool stillExistsText;
-    strcat(textChunk, tmpWord);
-    strcpy(tmpWord, "");
-    if (currentFileIdx < filesSize) {
-        while (strlen(textChunk) < BUFFERSIZE) {
-            symbol = getc(files[currentFileIdx]);
-            // Verify if the current file has ended
-            if (symbol == EOF) {
-                if (strlen(tmpWord) + strlen(textChunk) < BUFFERSIZE) {
-                    strcat(textChunk, tmpWord);
-                    strcpy(tmpWord, "");
-                }
-                incrementFileIdx = true;
+bool getTextChunk(const char** textChunk, int* chunkSize, int* fileId) {
+    while (currentFileIdx < filesSize) {
+        struct inputMap* map = &inputs[currentFileIdx];
+
+        // Cut the next chunk right after a delimiter (a word longer than the
+        // buffer is handed out whole)
+        if (currentOffset < map->size) {
+            size_t end = nextWordBoundary(map->data, map->size,
+                                          currentOffset + BUFFERSIZE);
+            *textChunk = map->data + currentOffset;
+            *chunkSize = end - currentOffset;
+            *fileId = currentFileIdx;
+            currentOffset = end;
+            return true;
+        }
+        currentFileIdx++;
+        currentOffset = 0;
+    }
+    return false;
+}
+
+void initMemory(void) {
+    if (!initArena(&runArena, ARENABLOCKSIZE)) {
+        perror("Error while allocating memory.\n");
+        exit(1);
+    }
+    initBufferPool(&chunkPool, &runArena, CHUNKBUFFERSIZE);
+    initBufferPool(&resultPool, &runArena, sizeof(int) * RESULTSIZE);
+}
+
+void* acquireBuffer(struct bufferPool* pool, struct largeBuffer* large,
+                    size_t size) {
+    void* buffer;
+
+    // Oversized requests are rare and share a buffer grown by doubling
+    if (size <= pool->bufferSize) {
+        buffer = acquirePoolBuffer(pool);
+    } else if (size <= large->capacity) {
+        buffer = large->data;
+    } else {
+        large->capacity = 2 * size;
+        buffer = large->data = arenaAlloc(&runArena, large->capacity);
+    }
+    if (buffer == NULL) {
+        perror("Error while allocating memory.\n");
+        exit(1);
+    }
+    return buffer;
+}
+
+void releaseBuffer(struct bufferPool* pool, void* buffer, size_t size) {
+    if (size <= pool->bufferSize) {
+        releasePoolBuffer(pool, buffer);
+    }
+}
+
+int packResult(int* packed, int fileId, const struct histogram* hist) {
+    int maxWordSize = hist->maxWordSize + 1;
+    int maxVowelCount = hist->maxVowelCount + 1;
+    int numLongWords = hist->overflow.numEntries;
+    int* next = packed + RESULTHEADER;
+
+    packed[0] = fileId;
+    packed[1] = maxWordSize;
+    packed[2] = maxVowelCount;
+    packed[3] = numLongWords;
+    memcpy(next, hist->wordSize, sizeof(int) * maxWordSize);
+    next += maxWordSize;
+    for (int i = 0; i < maxVowelCount; i++) {
+        memcpy(next, hist->vowelCount[i], sizeof(int) * maxWordSize);
+        next += maxWordSize;
+    }
+    // The words longer than the dense arrays go as triples of size, vowels and
+    // count
+    if (numLongWords > 0) {
+        sortedLongWords(&hist->overflow, (struct longWord*)next);
+        next += 3 * numLongWords;
+    }
+    return next - packed;
+}
+
+void unpackResult(const int* packed) {
+    int fileId = packed[0];
+    int maxWordSize = packed[1];
+    int maxVowelCount = packed[2];
+    int numLongWords = packed[3];
+    const int* next = packed + RESULTHEADER;
+
+    addWordSizes(&results, fileId, next, maxWordSize);
+    next += maxWordSize;
+    for (int i = 0; i < maxVowelCount; i++) {
+        addVowelCounts(&results, fileId, i, next, maxWordSize);
+        next += maxWordSize;
+    }
+    for (int i = 0; i < numLongWords; i++, next += 3) {
+        addLongWordResults(&results, fileId, next[0], next[1], next[2]);
+    }
+}
+
+void writeFinishedFiles(int finished) {
+    for (; nextFileOut < finished; nextFileOut++) {
+        writeFileResults(&writer, &results, nextFileOut,
+                         filenames[nextFileOut]);
+    }
+}
+
+struct chunkSlot* allocChunkSlots(int numSlots) {
+    struct chunkSlot* slots;
+
+    if ((slots = arenaAlloc(&runArena, sizeof(struct chunkSlot) * numSlots)) ==
+        NULL) {
+        perror("Error while allocating memory.\n");
+        exit(1);
+    }
+    for (int i = 0; i < numSlots; i++) {
+        slots[i].requests[0] = MPI_REQUEST_NULL;
+        slots[i].requests[1] = MPI_REQUEST_NULL;
+    }
+    return slots;
+}
+
+void sendChunk(int workerRank, int fileId, const char* textChunk,
+               int chunkSize) {
+    int header[2] = {fileId, chunkSize};
+
+    // The header alone (file -1) tells the worker to stop
+    if (fileId == -1) {
+        MPI_Send(header, 2, MPI_INT, workerRank, HEADERTAG, MPI_COMM_WORLD);
+        numMessages++;
+        numBytes += sizeof(header);
+        return;
+    }
+
+    // The worker has sent back the result of the chunk last sent in this
+    // slot, so its sends are over
+    struct chunkSlot* slot =
+        &chunkSlots[workerRank * chunksInFlight + nextSlot[workerRank]];
+    nextSlot[workerRank] = (nextSlot[workerRank] + 1) % chunksInFlight;
+    MPI_Waitall(2, slot->requests, MPI_STATUSES_IGNORE);
+    slot->header[0] = fileId;
+    slot->header[1] = chunkSize;
+    MPI_Isend(slot->header, 2, MPI_INT, workerRank, HEADERTAG, MPI_COMM_WORLD,
+              &slot->requests[0]);
+    MPI_Isend(textChunk, chunkSize, MPI_CHAR, workerRank, TEXTTAG,
+              MPI_COMM_WORLD, &slot->requests[1]);
+    numMessages += 2;
+    numBytes += sizeof(header) + chunkSize;
+    numChunks++;
+    pendingChunks[fileId]++;
+}
+
+void waitForWork(MPI_Request* request) {
+    double start = MPI_Wtime();
+    double idle = traceMark();
+
+    MPI_Wait(request, MPI_STATUS_IGNORE);
+    idleTime += MPI_Wtime() - start;
+    traceSpan("idle", idle);
+}
+
+void receiveText(struct chunkSlot* slot) {
+    // Receive the text chunk into a recycled buffer; it is processed by
+    // length, so it is not null-terminated
+    slot->text = acquireBuffer(&chunkPool, &slot->large, slot->header[1]);
+    MPI_Irecv(slot->text, slot->header[1], MPI_CHAR, 0, TEXTTAG,
+              MPI_COMM_WORLD, &slot->requests[1]);
+}
+
+void processChunks(void) {
+    struct wordScanner scanner;
+    static struct histogram hist;
+    struct chunkSlot* slot;
+    int* packed;
+    int flag;
+
+    initScanner(&scanner);
+    initHistogram(&hist);
+
+    // Ask for the first chunks at once, so that the next ones are on their way
+    // while one is processed
+    chunkSlots = allocChunkSlots(chunksInFlight);
+    for (int i = 0; i < chunksInFlight; i++) {
+        MPI_Irecv(chunkSlots[i].header, 2, MPI_INT, 0, HEADERTAG,
+                  MPI_COMM_WORLD, &chunkSlots[i].requests[0]);
+    }
+
+    for (int i = 0;; i = (i + 1) % chunksInFlight) {
+        slot = &chunkSlots[i];
+        if (slot->text == NULL) {
+            waitForWork(&slot->requests[0]);
+            if (slot->header[0] == -1) {
                 break;
             }
-            strcpy(completeSymbol, "");
-            ones = 0;
+            receiveText(slot);
+        }
 
-            // Verify the number of 1s in the most significant bits
-            for (int i = sizeof(symbol) * CHAR_BIT - 1; i >= 0; --i) {
-                int bit = (symbol >> i) & 1;
-                if (bit == 0) {
+        // Start receiving the texts of the chunks whose headers are in
+        for (int j = 1; j < chunksInFlight; j++) {
+            struct chunkSlot* ahead = &chunkSlots[(i + j) % chunksInFlight];
+            if (ahead->text == NULL) {
+                MPI_Test(&ahead->requests[0], &flag, MPI_STATUS_IGNORE);
+                if (!flag || ahead->header[0] == -1) {
                     break;
                 }
-                ones++;
+                receiveText(ahead);
             }
+        }
+        waitForWork(&slot->requests[1]);
+        fileId = slot->header[0];
+        double traced = traceMark();
+
+        // process text chunk
+        scanText(&scanner, slot->text, slot->header[1], true, &hist);
+
+        // Consider last word of file
+        endWord(&scanner, &hist);
+        releaseBuffer(&chunkPool, slot->text, slot->header[1]);
+        slot->text = NULL;
+        traceLap("scan", &traced);
+
+        // Save chunk processing results in a single message, or keep them
+        // for the reduction and only tell the root the chunk is done
+        if ((packed = acquirePoolBuffer(&resultPool)) == NULL) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+        if (reduceAtEnd) {
+            addHistogram(&results, fileId, &hist);
+            packed[0] = fileId;
+            MPI_Send(packed, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+        } else {
+            MPI_Send(packed, packResult(packed, fileId, &hist), MPI_INT, 0, 0,
+                     MPI_COMM_WORLD);
+        }
+        releasePoolBuffer(&resultPool, packed);
 
-            // Build the complete character (if it consists of more than
-            // 1byte)
-            strncat(completeSymbol, &symbol, 1);
-            for (int i = 1; i < ones; i++) {
-                symbol = getc(files[currentFileIdx]);
-                strncat(completeSymbol, &symbol, 1);
-            }
+        // Reset thread variables
+        clearHistogram(&hist);
+        traceSpan("merge", traced);
 
-            // Check if character is a delimiter
-            bool leaveLoop = false;
-            for (int i = 0; i < sizeof(delimiters) / sizeof(delimiters[0]);
-                 i++) {
-                if (strcmp(completeSymbol, delimiters[i]) == 0) {
-                    if (strlen(tmpWord) + strlen(textChunk) < BUFFERSIZE) {
-                        strcat(textChunk, tmpWord);
-                        strcpy(tmpWord, "");
-                    } else {
-                        leaveLoop = true;
-                    }
-                    break;
-                }
-            }
+        MPI_Irecv(slot->header, 2, MPI_INT, 0, HEADERTAG, MPI_COMM_WORLD,
+                  &slot->requests[0]);
+    }
+    freeHistogram(&hist);
 
-            strcat(tmpWord, completeSymbol);
-            if (leaveLoop) {
-                break;
-            }
+    // Nothing follows the stop, so the other headers asked for never come
+    for (int i = 0; i < chunksInFlight; i++) {
+        if (chunkSlots[i].requests[0] != MPI_REQUEST_NULL) {
+            MPI_Cancel(&chunkSlots[i].requests[0]);
+            MPI_Wait(&chunkSlots[i].requests[0], MPI_STATUS_IGNORE);
         }
     }
-    *fileId = currentFileIdx;
-    if (strlen(textChunk) <= 0) {
-        stillExistsText = false;
-    } else {
-        stillExistsText = true;
+}
+
+void initVariables(int numFiles, char** files, bool mapFiles) {
+    filesSize = numFiles;
+    // Allocate memory
+    initMemory();
+    if ((inputs = arenaAlloc(&runArena, sizeof(struct inputMap) *
+                                            filesSize)) == NULL) {
+        perror("Error while allocating memory.\n");
+        exit(1);
     }
 
-    if (incrementFileIdx) {
-        currentFileIdx++;
-        incrementFileIdx = false;
+    if ((filenames = arenaAlloc(&runArena, sizeof(char*) * filesSize)) ==
+        NULL) {
+        perror("Error while allocating memory.\n");
+        exit(1);
     }
-    return stillExistsText;
-}
 
-void initVariables(int argc, char** argv) {
-    filesSize = argc - 1;
-    // Allocate memory
-    if ((files = malloc(sizeof(FILE*) * (filesSize))) == NULL) {
+    if ((pendingChunks = arenaAlloc(&runArena, sizeof(int) * filesSize)) ==
+        NULL) {
         perror("Error while allocating memory.\n");
         exit(1);
     }
 
-    if ((filenames = malloc(sizeof(char*) * (filesSize))) == NULL) {
+    if (!allocResults(&results, filesSize, HISTSIZE)) {
         perror("Error while allocating memory.\n");
         exit(1);
     }
 
-    wordSizeResults = malloc(sizeof(int*) * (filesSize));
-    vowelCountResults = malloc(sizeof(int*) * (filesSize));
-    maximumSizeWordResults = malloc(sizeof(int) * (filesSize));
-    numberWordsResults = malloc(sizeof(int) * (filesSize));
-    if (wordSizeResults == NULL || vowelCountResults == NULL ||
-        maximumSizeWordResults == NULL || numberWordsResults == NULL) {
+    for (int i = 0; i < numFiles; i++) {
+        filenames[i] = files[i];
+        if (mapFiles && !mapInput(files[i], &inputs[i])) {
+            // end of file error
+            printf("Error while opening file!\n");
+            exit(1);
+        }
+    }
+    printf("Files presented.\n");
+}
+
+void gatherLongWords(int rank, int size) {
+    int numInts = 0;
+    int total = 0;
+    int* packed;
+    int* counts = NULL;
+    int* displs = NULL;
+    int* all = NULL;
+
+    // The other ranks pack their long words as groups of file, number of
+    // words and triples of size, vowels and count (the root's are in place)
+    for (int i = 0; i < filesSize && rank != 0; i++) {
+        if (results.overflow[i].numEntries > 0) {
+            numInts += 2 + 3 * results.overflow[i].numEntries;
+        }
+    }
+    if ((packed = arenaAlloc(&runArena, sizeof(int) * (numInts + 1))) ==
+        NULL) {
         perror("Error while allocating memory.\n");
         exit(1);
     }
+    for (int i = 0, *next = packed; i < filesSize && rank != 0; i++) {
+        if (results.overflow[i].numEntries > 0) {
+            next[0] = i;
+            next[1] = results.overflow[i].numEntries;
+            sortedLongWords(&results.overflow[i], (struct longWord*)(next + 2));
+            next += 2 + 3 * next[1];
+        }
+    }
 
-    // Process files given as input
-    for (int i = 0; i < filesSize; i++) {
-        maximumSizeWordResults[i] = 0;
-        numberWordsResults[i] = 0;
-        wordSizeResults[i] = malloc(sizeof(int) * (MAXSIZE));
-        vowelCountResults[i] = malloc(sizeof(int*) * (MAXSIZE));
-        if (wordSizeResults[i] == NULL || vowelCountResults[i] == NULL) {
+    if (rank == 0) {
+        counts = arenaAlloc(&runArena, sizeof(int) * size);
+        displs = arenaAlloc(&runArena, sizeof(int) * size);
+        if (counts == NULL || displs == NULL) {
             perror("Error while allocating memory.\n");
             exit(1);
         }
-        for (int j = 0; j < MAXSIZE; j++) {
-            wordSizeResults[i][j] = 0;
-            if ((vowelCountResults[i][j] = malloc(sizeof(int) * (MAXSIZE))) ==
-                NULL) {
-                perror("Error while allocating memory in.\n");
-                exit(1);
+    }
+    MPI_Gather(&numInts, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int r = 0; r < size; r++) {
+            displs[r] = total;
+            total += counts[r];
+        }
+        if ((all = arenaAlloc(&runArena, sizeof(int) * (total + 1))) ==
+            NULL) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+    }
+    MPI_Gatherv(packed, numInts, MPI_INT, all, counts, displs, MPI_INT, 0,
+                MPI_COMM_WORLD);
+
+    for (int i = 0; i < total; i += 2 + 3 * all[i + 1]) {
+        for (int j = 0; j < all[i + 1]; j++) {
+            const int* word = all + i + 2 + 3 * j;
+            addLongWords(&results.overflow[all[i]], word[0], word[1], word[2]);
+        }
+    }
+}
+
+void reduceResults(int rank, int size) {
+    int count = filesSize * results.dim;
+    MPI_Request requests[2];
+    double traced = traceMark();
+
+    // Sum the dense counters of all ranks into the root's results
+    if (rank == 0) {
+        MPI_Ireduce(MPI_IN_PLACE, results.wordSize, count, MPI_INT, MPI_SUM,
+                    0, MPI_COMM_WORLD, &requests[0]);
+        MPI_Ireduce(MPI_IN_PLACE, results.vowelCount, count * results.dim,
+                    MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD, &requests[1]);
+    } else {
+        MPI_Ireduce(results.wordSize, NULL, count, MPI_INT, MPI_SUM, 0,
+                    MPI_COMM_WORLD, &requests[0]);
+        MPI_Ireduce(results.vowelCount, NULL, count * results.dim, MPI_INT,
+                    MPI_SUM, 0, MPI_COMM_WORLD, &requests[1]);
+    }
+
+    // Long words do not fit a reduction, they are gathered in the meantime
+    gatherLongWords(rank, size);
+    MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+
+    if (rank == 0) {
+        deriveTotals(&results);
+    } else {
+        freeResults(&results);
+    }
+    traceSpan("merge", traced);
+}
+
+int packedResultSize(const struct histogram* hist) {
+    int maxWordSize = hist->maxWordSize + 1;
+
+    return RESULTHEADER + maxWordSize * (hist->maxVowelCount + 2) +
+           3 * hist->overflow.numEntries;
+}
+
+MPI_Offset wordBoundaryAfter(MPI_File file, MPI_Offset pos, MPI_Offset end,
+                             char* buffer) {
+    // Read from the byte before 'pos' (a boundary is never at the start of the
+    // text searched)
+    if (pos == 0) {
+        return 0;
+    }
+    int count = end - pos + 1 < IOCHUNKSIZE ? end - pos + 1 : IOCHUNKSIZE;
+    MPI_File_read_at(file, pos - 1, buffer, count, MPI_CHAR,
+                     MPI_STATUS_IGNORE);
+    size_t boundary = nextWordBoundary(buffer, count, 1);
+    return boundary < (size_t)count ? pos - 1 + (MPI_Offset)boundary
+                                    : NOBOUNDARY;
+}
+
+void scanFileRange(MPI_File file, MPI_Offset start, MPI_Offset end,
+                   char* buffer, struct histogram* hist) {
+    struct wordScanner scanner;
+    size_t kept = 0;
+
+    // Stream the range through the buffer, keeping the bytes of a character
+    // cut short by the end of a read for the next one
+    initScanner(&scanner);
+    while (start < end) {
+        int count = end - start < (MPI_Offset)(IOCHUNKSIZE - kept)
+                        ? end - start
+                        : (MPI_Offset)(IOCHUNKSIZE - kept);
+        MPI_File_read_at(file, start, buffer + kept, count, MPI_CHAR,
+                         MPI_STATUS_IGNORE);
+        start += count;
+        size_t length = kept + count;
+        size_t consumed =
+            scanText(&scanner, buffer, length, start == end, hist);
+        kept = length - consumed;
+        memmove(buffer, buffer + consumed, kept);
+    }
+    endWord(&scanner, hist);
+}
+
+void feedFileRange(MPI_File file, MPI_Offset start, MPI_Offset end,
+                   int fileId) {
+    struct textBlock* previous = NULL;
+    struct textBlock* block;
+    size_t left = 0;
+
+    while (start < end) {
+        // Start with the word cut at the end of the previous block
+        block = emptyTextBlock(&rankPool);
+        if (!growTextBlock(&rankPool, block, 2 * left)) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+        if (left > 0) {
+            memcpy(block->data, previous->data + previous->size, left);
+        }
+        block->size = left;
+        block->fileId = fileId;
+
+        // Fill the block up and cut it right after its last delimiter,
+        // growing it while it holds a single word
+        for (;;) {
+            MPI_Offset room = block->capacity - block->size;
+            int count = end - start < room ? end - start : room;
+            MPI_File_read_at(file, start, block->data + block->size, count,
+                             MPI_CHAR, MPI_STATUS_IGNORE);
+            start += count;
+            block->size += count;
+            if (start == end) {
+                left = 0;
+                break;
+            }
+            size_t cut = lastWordBoundary(block->data, block->size);
+            if (cut > 0) {
+                left = block->size - cut;
+                block->size = cut;
+                break;
             }
-            for (int l = 0; l < MAXSIZE; l++) {
-                vowelCountResults[i][j][l] = 0;
+            if (!growTextBlock(&rankPool, block, 2 * block->capacity)) {
+                perror("Error while allocating memory.\n");
+                exit(1);
             }
         }
+        publishTextBlock(&rankPool, block);
+        previous = block;
     }
+}
 
-    for (int i = 1; i < argc; i++) {
-        filenames[i - 1] = argv[i];
-        files[i - 1] = fopen(argv[i], "r");
-        if (files[i - 1] == NULL) {
-            // end of file error
-            printf("Error while opening file!\n");
+void processFilesParallelIO(int rank, int size, int numFiles, char** files) {
+    static struct histogram hist;
+    MPI_Offset* cuts;
+    MPI_Offset fileSize;
+    MPI_File file;
+    MPI_Status status;
+    char* buffer;
+    int* packed;
+    int resultSize;
+
+    if (rank == 0) {
+        initVariables(numFiles, files, false);
+    } else {
+        initMemory();
+        filesSize = numFiles;
+        if (reduceAtEnd && !allocResults(&results, numFiles, HISTSIZE)) {
+            perror("Error while allocating memory.\n");
             exit(1);
         }
     }
-    printf("Files presented.\n");
-}
+    buffer = arenaAlloc(&runArena, IOCHUNKSIZE);
+    cuts = arenaAlloc(&runArena, sizeof(MPI_Offset) * (size + 1));
+    if (buffer == NULL || cuts == NULL) {
+        perror("Error while allocating memory.\n");
+        exit(1);
+    }
+    initHistogram(&hist);
+    if (numThreads > 0 &&
+        !startRankThreads(&rankPool, numThreads, &results, &runArena)) {
+        perror("Error on creating the threads of the rank.\n");
+        exit(1);
+    }
 
-void printResults() {
-    for (int k = 0; k < filesSize; k++) {
-        printf("File name: %s\n", filenames[k]);
-        printf("Total number of words: %d\n", numberWordsResults[k]);
-        printf("Word length\n");
-
-        printf("   ");
-        for (int i = 1; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("%6d", i);
-        }
-        printf("\n   ");
-        for (int i = 1; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("%6d", wordSizeResults[k][i]);
-        }
-        printf("\n   ");
-        for (int i = 1; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("%6.2f", ((float)wordSizeResults[k][i] * 100.0) /
-                                (float)numberWordsResults[k]);
-        }
-        for (int i = 0; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("\n%2d ", i);
-            for (int j = 1; j < i; j++) {
-                printf("%6s", " ");
+    for (int fileId = 0; fileId < numFiles; fileId++) {
+        double traced = traceMark();
+        if (MPI_File_open(MPI_COMM_WORLD, files[fileId], MPI_MODE_RDONLY,
+                          MPI_INFO_NULL, &file) != MPI_SUCCESS) {
+            if (rank == 0) {
+                printf("Error while opening file!\n");
             }
-            if (i == 0) {
-                for (int j = 1; j < maximumSizeWordResults[k] + 1; j++) {
-                    if (wordSizeResults[k][j] > 0) {
-                        printf("%6.1f", (vowelCountResults[k][i][j] * 100.0) /
-                                            (float)wordSizeResults[k][j]);
-                    } else {
-                        printf("%6.1f", 0.0);
-                    }
-                }
-            } else {
-                for (int j = i; j < maximumSizeWordResults[k] + 1; j++) {
-                    if (wordSizeResults[k][j] > 0) {
-                        printf("%6.1f", (vowelCountResults[k][i][j] * 100.0) /
-                                            (float)wordSizeResults[k][j]);
-                    } else {
-                        printf("%6.1f", 0.0);
-                    }
-                }
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        MPI_File_get_size(file, &fileSize);
+
+        // Every rank finds the first word boundary of its share of the file,
+        // and the neighbours agree on the boundaries found (a share lying
+        // inside a word goes to the rank before)
+        MPI_Offset candidate =
+            wordBoundaryAfter(file, fileSize * rank / size,
+                              fileSize * (rank + 1) / size, buffer);
+        traceLap("fetch", &traced);
+        double start = MPI_Wtime();
+        MPI_Allgather(&candidate, 1, MPI_OFFSET, cuts, 1, MPI_OFFSET,
+                      MPI_COMM_WORLD);
+        idleTime += MPI_Wtime() - start;
+        traceLap("idle", &traced);
+        cuts[size] = fileSize;
+        for (int r = size - 1; r >= 0; r--) {
+            if (cuts[r] > cuts[r + 1]) {
+                cuts[r] = cuts[r + 1];
+            }
+        }
+        if (numThreads > 0) {
+            // The threads add their histograms to the results of the rank
+            feedFileRange(file, cuts[rank], cuts[rank + 1], fileId);
+            traceLap("fetch", &traced);
+        } else {
+            scanFileRange(file, cuts[rank], cuts[rank + 1], buffer, &hist);
+            traceLap("scan", &traced);
+        }
+        MPI_File_close(&file);
+
+        // Only the histograms travel to the root, at once at the end if the
+        // results are reduced
+        numChunks += size;
+        if ((rank == 0 || reduceAtEnd) && numThreads == 0) {
+            addHistogram(&results, fileId, &hist);
+        }
+        if (!reduceAtEnd && rank == 0) {
+            for (int i = 1; i < size; i++) {
+                MPI_Probe(MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &status);
+                MPI_Get_count(&status, MPI_INT, &resultSize);
+                packed = acquireBuffer(&resultPool, &largeResult,
+                                       sizeof(int) * resultSize);
+                MPI_Recv(packed, resultSize, MPI_INT, status.MPI_SOURCE, 0,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                numMessages++;
+                numBytes += sizeof(int) * resultSize;
+                unpackResult(packed);
+                releaseBuffer(&resultPool, packed, sizeof(int) * resultSize);
             }
+            writeFinishedFiles(fileId + 1);
+        } else if (!reduceAtEnd) {
+            resultSize = packedResultSize(&hist);
+            packed = acquireBuffer(&resultPool, &largeResult,
+                                   sizeof(int) * resultSize);
+            MPI_Send(packed, packResult(packed, fileId, &hist), MPI_INT, 0,
+                     0, MPI_COMM_WORLD);
+            releaseBuffer(&resultPool, packed, sizeof(int) * resultSize);
+        }
+        clearHistogram(&hist);
+        traceSpan("merge", traced);
+    }
+    freeHistogram(&hist);
+    if (numThreads > 0 && !stopRankThreads(&rankPool)) {
+        perror("Error on waiting for the threads of the rank.\n");
+        exit(1);
+    }
+
+    if (reduceAtEnd) {
+        reduceResults(rank, size);
+    }
+}
+
+void scanRootChunk(const char* textChunk, int chunkSize, int fileId) {
+    static struct wordScanner scanner;
+    static struct histogram hist;
+    static bool initialized = false;
+
+    if (!initialized) {
+        initScanner(&scanner);
+        initHistogram(&hist);
+        initialized = true;
+    }
+    double traced = traceMark();
+    scanText(&scanner, textChunk, chunkSize, true, &hist);
+    endWord(&scanner, &hist);
+    addHistogram(&results, fileId, &hist);
+    clearHistogram(&hist);
+    numRootChunks++;
+    traceSpan("scan", traced);
+}
+
+void printResults() {
+    // Write the files still missing, all final by now
+    writeFinishedFiles(filesSize);
+    if (!closeResultWriter(&writer)) {
+        perror("Error while writing the results.\n");
+        exit(1);
+    }
+}
+
+void reportRun(int rank) {
+    char owner[32];
+
+    if (rank == 0) {
+        printResults();
+        freeResults(&results);
+
+        clock_gettime(CLOCK_REALTIME, &t1);
+        double exec_time =
+            (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / BILLION;
+        printf("\nElapsed time = %.6f s\n", exec_time);
+
+        long perChunk = numChunks > 0 ? numChunks : 1;
+        printf("Messages: %ld chunks, %.2f messages and %.1f bytes per "
+               "chunk.\n",
+               numChunks, (double)numMessages / perChunk,
+               (double)numBytes / perChunk);
+        if (numThreads > 0) {
+            printf("Root threads: %d threads, %ld text slices.\n", numThreads,
+                   rankPool.numSlices);
+        }
+        if (rootWorks) {
+            printf("Root chunks: %ld chunks scanned by the root.\n",
+                   numRootChunks);
+        }
+        printArenaStats("Root", &runArena);
+        printPoolStats("Root result", &resultPool);
+        freeArena(&runArena);
+        fflush(stdout);
+        MPI_Barrier(MPI_COMM_WORLD);
+        return;
+    }
+
+    // Report the allocations once the root has printed the results
+    MPI_Barrier(MPI_COMM_WORLD);
+    printf("Worker %d idle time = %.6f s\n", rank, idleTime);
+    if (numThreads > 0) {
+        printf("Worker %d threads: %d threads, %ld text slices.\n", rank,
+               numThreads, rankPool.numSlices);
+    }
+    snprintf(owner, sizeof(owner), "Worker %d", rank);
+    printArenaStats(owner, &runArena);
+    snprintf(owner, sizeof(owner), "Worker %d chunk", rank);
+    printPoolStats(owner, &chunkPool);
+    snprintf(owner, sizeof(owner), "Worker %d result", rank);
+    printPoolStats(owner, &resultPool);
+    freeArena(&runArena);
+}
+
+void gatherTrace(int rank, int size) {
+    char label[32];
+    char* events;
+    char* all = NULL;
+    int* counts = NULL;
+    int* displs = NULL;
+    int total = 0;
+    size_t len;
+
+    // Every rank formats its own events, which the root joins by commas
+    snprintf(label, sizeof(label), "rank %d", rank);
+    if ((events = formatTrace(rank, label, &len)) == NULL) {
+        perror("Error while allocating memory.\n");
+        exit(1);
+    }
+    int count = len;
+    if (rank == 0) {
+        counts = malloc(sizeof(int) * size);
+        displs = malloc(sizeof(int) * size);
+        if (counts == NULL || displs == NULL) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+    }
+    MPI_Gather(&count, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int r = 0; r < size; r++) {
+            displs[r] = total;
+            total += counts[r] + 2;
+        }
+        if ((all = malloc(total)) == NULL) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+        for (int r = 0; r < size - 1; r++) {
+            memcpy(all + displs[r] + counts[r], ",\n", 2);
         }
-        printf("\n\n");
     }
+    MPI_Gatherv(events, count, MPI_CHAR, all, counts, displs, MPI_CHAR, 0,
+                MPI_COMM_WORLD);
+
+    if (rank == 0 && !writeTrace(tracePath, all, total - 2)) {
+        perror("Error while writing the trace.\n");
+    }
+    free(all);
+    free(counts);
+    free(displs);
+    free(events);
+    freeTrace();
 }
 
 /**
@@ -255,296 +858,237 @@ void printResults() {
  */
 int main(int argc, char** argv) {
     int rank, size;
+    bool parallelIO = false;
+    enum outputFormat format = OUTPUT_TEXT;
+    const char* outputPath = NULL;
+    int opt;
+
+    int provided;
 
-    MPI_Init(&argc, &argv);
+    // Only the main thread of a rank makes MPI calls
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    initTextScan();
     MPI_Comm_size(MPI_COMM_WORLD, &size);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
     totalNumWorkers = size - 1;
 
+    // Validate options and number of arguments passed to the program
+    while ((opt = getopt(argc, argv, "irwk:t:F:o:T:")) != -1) {
+        if (opt == 'i') {
+            parallelIO = true;
+        } else if (opt == 'r') {
+            reduceAtEnd = true;
+        } else if (opt == 'w') {
+            rootWorks = true;
+        } else if (opt == 'k' && atoi(optarg) > 0) {
+            chunksInFlight = atoi(optarg);
+        } else if (opt == 't' && atoi(optarg) > 0) {
+            numThreads = atoi(optarg);
+        } else if (opt == 'F' && parseOutputFormat(optarg, &format)) {
+            continue;
+        } else if (opt == 'o') {
+            outputPath = optarg;
+        } else if (opt == 'T') {
+            tracePath = optarg;
+        } else {
+            if (rank == 0) {
+                printf("Usage: %s [-i] [-r] [-w] [-k CHUNKS] [-t THREADS] "
+                       "[-F text|json|csv|binary] [-o FILE] [-T FILE] "
+                       "file...\n",
+                       argv[0]);
+            }
+            exit(1);
+        }
+    }
+    if (optind >= argc) {
+        if (rank == 0) {
+            printf("The program needs at least one text file to parse!\n");
+        }
+        exit(1);
+    }
+    if (format != OUTPUT_TEXT && outputPath == NULL) {
+        if (rank == 0) {
+            printf("The json, csv and binary formats need an output file (-o FILE)!\n");
+        }
+        exit(1);
+    }
+    if (rank == 0 && !openResultWriter(&writer, outputPath, format)) {
+        printf("Error while opening file!\n");
+        exit(1);
+    }
+
+    // Trace the main thread of every rank (and its threads, if any) from a
+    // common start
+    if (tracePath != NULL) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (!initTrace(1 + numThreads)) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+        bindTraceThread(0, "main");
+    }
+
+    // Threads of a rank scan the share of the files it reads, and their results
+    // are reduced with those of the other ranks
+    if (numThreads > 0) {
+        if (provided < MPI_THREAD_FUNNELED) {
+            if (rank == 0) {
+                printf("The MPI library does not support threads!\n");
+            }
+            exit(1);
+        }
+        parallelIO = true;
+        reduceAtEnd = true;
+    }
+
+    // Let every rank read its own share of the files
+    if (parallelIO) {
+        if (rank == 0) {
+            clock_gettime(CLOCK_REALTIME, &t0);
+        }
+        processFilesParallelIO(rank, size, argc - optind, argv + optind);
+        reportRun(rank);
+        if (tracePath != NULL) {
+            gatherTrace(rank, size);
+        }
+        MPI_Finalize();
+        exit(EXIT_SUCCESS);
+    }
+
     // Validate number of workers
-    if (totalNumWorkers < 1) {
+    if (totalNumWorkers < 1 && !rootWorks) {
         printf("The program needs at least one worker!\n");
         exit(1);
     }
 
     if (rank == 0) {
         srandom((unsigned int)getpid());
-        // Validate number of arguments passed to the program
-        if (argc <= 1) {
-            printf("The program needs at least one text file to parse!\n");
-            exit(1);
-        }
-
-        initVariables(argc, argv);
+        initVariables(argc - optind, argv + optind, true);
 
         // t0 = ((double)clock()) / CLOCKS_PER_SEC;
         clock_gettime(CLOCK_REALTIME, &t0);
 
         // process files
-        char textChunk[BUFFERSIZE] = "";
+        const char* textChunk;
+        int chunkSize;
         int fileId = -1;
         bool continueProcess = true;
 
         int workingWorkers = 0;
 
-        for (int workerId = 1; workerId <= totalNumWorkers; workerId++) {
-            strcpy(textChunk, "");
-            fileId = -1;
-            continueProcess = getTextChunk(textChunk, &fileId);
-
-            if (continueProcess) {
-                workingWorkers++;
-                MPI_Send(&fileId, 1, MPI_INT, workerId, 0, MPI_COMM_WORLD);
-                int chunkSize = strlen(textChunk);
-                MPI_Send(&chunkSize, 1, MPI_INT, workerId, 0, MPI_COMM_WORLD);
-                MPI_Send(textChunk, chunkSize, MPI_CHAR, workerId, 0,
-                         MPI_COMM_WORLD);
+        // Keep several chunks on their way to every worker
+        chunkSlots = allocChunkSlots(size * chunksInFlight);
+        if ((nextSlot = arenaAlloc(&runArena, sizeof(int) * size)) == NULL) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+        double traced = traceMark();
+        for (int i = 0; i < chunksInFlight; i++) {
+            for (int workerId = 1; workerId <= totalNumWorkers; workerId++) {
+                fileId = -1;
+                continueProcess =
+                    getTextChunk(&textChunk, &chunkSize, &fileId);
+
+                if (continueProcess) {
+                    workingWorkers++;
+                    sendChunk(workerId, fileId, textChunk, chunkSize);
+                }
             }
         }
+        traceSpan("fetch", traced);
 
         int workerRank;
-        int oldMaxWordSize = 0;
-        int* wordSizes;
-        int* vowelCounts;
-        while (workingWorkers > 0) {
-            MPI_Recv(&workerRank, 1, MPI_INT, MPI_ANY_SOURCE, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            MPI_Recv(&fileId, 1, MPI_INT, workerRank, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            MPI_Recv(&maxWordSize, 1, MPI_INT, workerRank, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            MPI_Recv(&maxVowelCount, 1, MPI_INT, workerRank, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            workingWorkers--;
-
-            if (maxWordSize != oldMaxWordSize) {
-                if (oldMaxWordSize != 0) {
-                    free(wordSizes);
-                    free(vowelCounts);
-                }
-                if ((wordSizes = calloc(maxWordSize, sizeof(int))) == NULL) {
-                    perror("Error while allocating memory.\n");
-                    exit(1);
-                }
-                if ((vowelCounts = calloc(maxWordSize, sizeof(int))) == NULL) {
-                    perror("Error while allocating memory.\n");
-                    exit(1);
+        int resultSize;
+        int* packed = acquirePoolBuffer(&resultPool);
+        MPI_Status status;
+        if (packed == NULL) {
+            perror("Error while allocating memory.\n");
+            exit(1);
+        }
+        while (workingWorkers > 0 || (rootWorks && continueProcess)) {
+            // Scan a chunk unless a worker waits for its next one
+            int resultPending = false;
+            if (rootWorks && continueProcess && workingWorkers > 0) {
+                MPI_Iprobe(MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &resultPending,
+                           MPI_STATUS_IGNORE);
+            }
+            if (rootWorks && continueProcess && !resultPending) {
+                fileId = -1;
+                continueProcess =
+                    getTextChunk(&textChunk, &chunkSize, &fileId);
+                if (continueProcess) {
+                    scanRootChunk(textChunk, chunkSize, fileId);
                 }
+                continue;
             }
 
-            MPI_Recv(wordSizes, maxWordSize, MPI_INT, workerRank, 0,
-                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-            for (int i = 0; i < maxWordSize; i++) {
-                wordSizeResults[fileId][i] += wordSizes[i];
-                numberWordsResults[fileId] += wordSizes[i];
-                if (i > maximumSizeWordResults[fileId] && wordSizes[i] > 0) {
-                    maximumSizeWordResults[fileId] = i;
-                }
+            // Receive the packed result of the next worker to finish
+            traced = traceMark();
+            MPI_Recv(packed, RESULTSIZE, MPI_INT, MPI_ANY_SOURCE, 0,
+                     MPI_COMM_WORLD, &status);
+            traceLap("idle", &traced);
+            MPI_Get_count(&status, MPI_INT, &resultSize);
+            workerRank = status.MPI_SOURCE;
+            numMessages++;
+            numBytes += sizeof(int) * resultSize;
+            workingWorkers--;
+            pendingChunks[packed[0]]--;
+            if (!reduceAtEnd) {
+                unpackResult(packed);
             }
-            for (int i = 0; i < maxVowelCount; i++) {
-                MPI_Recv(vowelCounts, maxWordSize, MPI_INT, workerRank, 0,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                for (int j = 0; j < maxWordSize; j++) {
-                    vowelCountResults[fileId][i][j] += vowelCounts[j];
-                }
+
+            // Write the files fully handed out whose chunks are all back
+            int finished = nextFileOut;
+            while (!reduceAtEnd && finished < currentFileIdx &&
+                   pendingChunks[finished] == 0) {
+                finished++;
             }
+            writeFinishedFiles(finished);
+            traceLap("merge", &traced);
 
-            strcpy(textChunk, "");
             fileId = -1;
-            continueProcess = getTextChunk(textChunk, &fileId);
+            continueProcess = getTextChunk(&textChunk, &chunkSize, &fileId);
 
             if (continueProcess) {
-                MPI_Send(&fileId, 1, MPI_INT, workerRank, 0, MPI_COMM_WORLD);
-                int chunkSize = strlen(textChunk);
-                MPI_Send(&chunkSize, 1, MPI_INT, workerRank, 0, MPI_COMM_WORLD);
-                MPI_Send(textChunk, chunkSize, MPI_CHAR, workerRank, 0,
-                         MPI_COMM_WORLD);
+                sendChunk(workerRank, fileId, textChunk, chunkSize);
                 workingWorkers++;
             }
+            traceSpan("fetch", traced);
         }
-        int endSignal = -1;
+        releasePoolBuffer(&resultPool, packed);
         for (int workerId = 1; workerId <= totalNumWorkers; workerId++) {
-            MPI_Send(&endSignal, 1, MPI_INT, workerId, 0, MPI_COMM_WORLD);
+            sendChunk(workerId, -1, NULL, 0);
+        }
+        for (int i = 0; i < size * chunksInFlight; i++) {
+            MPI_Waitall(2, chunkSlots[i].requests, MPI_STATUSES_IGNORE);
+        }
+        if (reduceAtEnd) {
+            reduceResults(rank, size);
         }
 
-        printResults();
-
-        clock_gettime(CLOCK_REALTIME, &t1);
-        double exec_time =
-            (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / BILLION;
-        printf("\nElapsed time = %.6f s\n", exec_time);
-
+        for (int i = 0; i < filesSize; i++) {
+            unmapInput(&inputs[i]);
+        }
+        reportRun(rank);
     } else {
-        int chunkSize = 0;
-        char* textChunk;
-        char completeSymbol[MAXCHARSIZE];
-        bool increment;
-        int control;
-        int numVowels = 0;
-        int stringSize = 0;
-
-        int* wordSize = malloc(sizeof(int) * (MAXSIZE));
-        int** vowelCount = malloc(sizeof(int*) * (MAXSIZE));
-        if (wordSize == NULL || vowelCount == NULL) {
+        initMemory();
+        filesSize = argc - optind;
+        if (reduceAtEnd && !allocResults(&results, filesSize, HISTSIZE)) {
             perror("Error while allocating memory.\n");
             exit(1);
         }
-
-        // Process files given as input
-        for (int j = 0; j < MAXSIZE; j++) {
-            wordSize[j] = 0;
-            if ((vowelCount[j] = calloc(MAXSIZE, sizeof(int))) == NULL) {
-                perror("Error while allocating memory in.\n");
-                exit(1);
-            }
+        processChunks();
+        if (reduceAtEnd) {
+            reduceResults(rank, size);
         }
 
-        while (chunkSize != -1) {
-            MPI_Recv(&fileId, 1, MPI_INT, 0, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            if (fileId == -1) {
-                break;
-            }
-            MPI_Recv(&chunkSize, 1, MPI_INT, 0, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-
-            if ((textChunk = calloc(chunkSize + 1, sizeof(char))) == NULL) {
-                perror("Error while allocating memory.\n");
-                exit(1);
-            }
-            strcpy(textChunk, "");
-            MPI_Recv(textChunk, chunkSize, MPI_CHAR, 0, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-
-            textChunk[chunkSize] = '\0';
-            // process text chunk
-            for (int h = 0; h < strlen(textChunk); h++) {
-                symbol = textChunk[h];
-                strcpy(completeSymbol, "");
-                increment = true;
-                ones = 0;
-
-                // Verify the number of 1s in the most significant bits
-
-                for (int i = sizeof(symbol) * CHAR_BIT - 1; i >= 0; --i) {
-                    int bit = (symbol >> i) & 1;
-                    if (bit == 0) {
-                        break;
-                    }
-                    ones++;
-                }
-
-                // Build the complete character (if it consists of more than 1
-                // byte)
-
-                strncat(completeSymbol, &symbol, 1);
-                for (int i = 1; i < ones; i++) {
-                    h++;
-                    symbol = textChunk[h];
-                    strncat(completeSymbol, &symbol, 1);
-                }
-
-                // Check if character is a delimiter
-
-                for (int i = 0; i < sizeof(delimiters) / sizeof(delimiters[0]);
-                     i++) {
-                    if (strcmp(completeSymbol, delimiters[i]) == 0) {
-                        if (stringSize > 0) {
-                            wordSize[stringSize]++;
-                            vowelCount[numVowels][stringSize]++;
-                        }
-                        control = 1;
-                        numVowels = 0;
-                        stringSize = 0;
-                        break;
-                    }
-                }
-
-                // Skip remaining steps if current character is a delimiter
-
-                if (control == 1) {
-                    control = 0;
-                    continue;
-                }
-
-                // Increment word size and add character to current word (if
-                // applicable)
-
-                for (int i = 0; i < sizeof(mergers) / sizeof(mergers[0]); i++) {
-                    if (strcmp(completeSymbol, mergers[i]) == 0) {
-                        increment = false;
-                        break;
-                    }
-                }
-                if (increment) {
-                    stringSize++;
-                    if (stringSize > maxWordSize) {
-                        maxWordSize = stringSize;
-                    }
-                }
-
-                // Increment number of vowels (if applicable)
-
-                for (int i = 0; i < sizeof(vowels) / sizeof(vowels[0]); i++) {
-                    if (strcmp(completeSymbol, vowels[i]) == 0) {
-                        numVowels++;
-                        if (numVowels > maxVowelCount) {
-                            maxVowelCount = numVowels;
-                        }
-                        break;
-                    }
-                }
-            }
-
-            // Consider last word of file
-
-            if (stringSize > 0) {
-                wordSize[stringSize]++;
-                vowelCount[numVowels][stringSize]++;
-                if (stringSize > maxWordSize) {
-                    maxWordSize = stringSize;
-                }
-                numVowels = 0;
-                stringSize = 0;
-            }
-
-            maxWordSize = maxWordSize + 1;
-            maxVowelCount = maxVowelCount + 1;
-
-            free(textChunk);
-
-            // Save chunk processing results
-            MPI_Send(&rank, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-            MPI_Send(&fileId, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-            MPI_Send(&maxWordSize, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-            MPI_Send(&maxVowelCount, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-
-            // send wordSizes
-            MPI_Send(wordSize, maxWordSize, MPI_INT, 0, 0, MPI_COMM_WORLD);
-
-            // send vowelCounts
-            for (int i = 0; i < maxVowelCount; i++) {
-                MPI_Send(vowelCount[i], maxWordSize, MPI_INT, 0, 0,
-                         MPI_COMM_WORLD);
-            }
-
-            // Reset thread variables
-
-            for (int i = 0; i < MAXSIZE; i++) {
-                wordSize[i] = 0;
-            }
-            for (int i = 0; i < MAXSIZE; i++) {
-                for (int j = 0; j < MAXSIZE; j++) {
-                    vowelCount[i][j] = 0;
-                }
-            }
-            maxWordSize = 0;
-            maxVowelCount = 0;
-        }
+        reportRun(rank);
         // printf("Worker, with id %d, has successfully terminated.\n", rank);
     }
+    if (tracePath != NULL) {
+        gatherTrace(rank, size);
+    }
 
     MPI_Finalize();
 
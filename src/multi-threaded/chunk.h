@@ -9,6 +9,8 @@
 #ifndef CHUNK_H
 #define CHUNK_H
 
+#include <stddef.h>
+
 /**
  *  \brief structure containing a portion of text from a given file.
  */
@@ -17,8 +19,11 @@ struct Chunk {
     /** \brief identifier of the file the text chunk belongs to. */
     int fileId;
 
-    /** \brief portion of text belonging to a text file. */
-    char* textChunk;
+    /** \brief portion of text belonging to a text file (a range of the file's mapping or of a buffer of the reading pipeline, never copied nor null-terminated). */
+    const char* textChunk;
+
+    /** \brief size (number of bytes) of the portion of text. */
+    size_t textSize;
 
 };
 
@@ -0,0 +1,360 @@
+/**
+ *  \file chunkRing.c (implementation file)
+ *
+ *  \brief Pipeline feeding the workers from a dedicated reader thread.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "chunkRing.h"
+#include "../common/textScan.h"
+#include "../common/trace.h"
+
+/** \brief smallest number of chunk buffers of the pipeline */
+#define MINRINGDEPTH 2
+
+/** \brief reader thread return status value */
+static int statusReader;
+
+/**
+ *  \brief Initialization of a bounded queue.
+ *
+ *  \param queue queue to initialize.
+ *  \param capacity minimum number of values the queue must hold.
+ *  \param arena arena the cells are allocated from.
+ *
+ *  \return false if memory could not be allocated.
+ */
+static bool initQueue(struct ringQueue* queue, int capacity,
+                      struct arena* arena) {
+    size_t size = 1;
+
+    while (size < (size_t)capacity) {
+        size *= 2;
+    }
+    if ((queue->cells = arenaAlloc(arena, sizeof(struct ringCell) * size)) ==
+        NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+    }
+    queue->mask = size - 1;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    return true;
+}
+
+/**
+ *  \brief Insertion of a value in a bounded queue.
+ *
+ *  \param queue queue to update.
+ *  \param value value to insert.
+ *
+ *  \return false if the queue is full.
+ */
+static bool pushQueue(struct ringQueue* queue, int value) {
+    size_t pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    struct ringCell* cell;
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq =
+            atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->head, &pos, pos + 1, memory_order_relaxed,
+                    memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+    cell->value = value;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+/**
+ *  \brief Removal of a value from a bounded queue.
+ *
+ *  \param queue queue to update.
+ *  \param value value removed.
+ *
+ *  \return false if the queue is empty.
+ */
+static bool popQueue(struct ringQueue* queue, int* value) {
+    size_t pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    struct ringCell* cell;
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t seq =
+            atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->tail, &pos, pos + 1, memory_order_relaxed,
+                    memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+    *value = cell->value;
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1,
+                          memory_order_release);
+    return true;
+}
+
+/**
+ *  \brief Retrieval of an empty buffer by the reader.
+ *
+ *  \param ring pipeline.
+ *
+ *  \return index of the buffer.
+ */
+static int acquireBuffer(struct chunkRing* ring) {
+    bool stalled = false;
+    int idx;
+
+    while (!popQueue(&ring->empty, &idx)) {
+        if (!stalled) {
+            stalled = true;
+            atomic_fetch_add(&ring->producerStalls, 1);
+        }
+        sched_yield();
+    }
+    ring->buffers[idx].size = 0;
+    return idx;
+}
+
+/**
+ *  \brief Publication of a filled buffer by the reader.
+ *
+ *  \param ring pipeline.
+ *  \param idx index of the buffer.
+ *
+ */
+static void publishBuffer(struct chunkRing* ring, int idx) {
+    // Never full: the queue holds as many cells as there are buffers
+    pushQueue(&ring->filled, idx);
+    atomic_fetch_add(&ring->numChunks, 1);
+}
+
+/**
+ *  \brief Growth of a buffer to hold at least a given number of bytes.
+ *
+ *  The larger buffer is taken from the arena; the former one goes back to the
+ * pool if it came from it.
+ *
+ *  \param ring pipeline.
+ *  \param buffer buffer to grow.
+ *  \param capacity memory space (number of bytes) required.
+ *
+ *  \return false if memory could not be allocated.
+ */
+static bool growBuffer(struct chunkRing* ring, struct chunkBuffer* buffer,
+                       size_t capacity) {
+    char* data;
+
+    if (capacity <= buffer->capacity) {
+        return true;
+    }
+    if ((data = arenaAlloc(ring->pool.arena, capacity)) == NULL) {
+        return false;
+    }
+    memcpy(data, buffer->data, buffer->size);
+    if (buffer->capacity == ring->pool.bufferSize) {
+        releasePoolBuffer(&ring->pool, buffer->data);
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+/**
+ *  \brief Function reader.
+ *
+ *  Reads every file in succession into the empty buffers. A full buffer is cut
+ * right after a delimiter close to its end; the bytes after the cut (the start
+ * of a word) are moved to the next buffer before the full one is published. A
+ * buffer holding a single word is grown until the word ends.
+ *
+ *  \param par pointer to the pipeline.
+ */
+static void* readerThread(void* par) {
+    struct chunkRing* ring = par;
+    int idx = acquireBuffer(ring);
+    struct chunkBuffer* buffer = &ring->buffers[idx];
+    ssize_t bytesRead = 0;
+    int fd;
+
+    statusReader = EXIT_SUCCESS;
+    for (int fileId = 0; fileId < ring->numFiles; fileId++) {
+        // A file that cannot be opened counts as empty
+        if ((fd = open(ring->filenames[fileId], O_RDONLY)) < 0) {
+            perror("Error while opening file in readerThread.\n");
+            statusReader = EXIT_FAILURE;
+            continue;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        buffer->fileId = fileId;
+        for (;;) {
+            // Publish the buffer once full, keeping the last word for the next
+            if (buffer->size == buffer->capacity) {
+                size_t cut = lastWordBoundary(buffer->data, buffer->size);
+                if (cut == 0) {
+                    if (!growBuffer(ring, buffer, 2 * buffer->capacity)) {
+                        break;
+                    }
+                    continue;
+                }
+                int nextIdx = acquireBuffer(ring);
+                struct chunkBuffer* next = &ring->buffers[nextIdx];
+                size_t left = buffer->size - cut;
+                if (!growBuffer(ring, next, 2 * left)) {
+                    break;
+                }
+                memcpy(next->data, buffer->data + cut, left);
+                next->size = left;
+                next->fileId = fileId;
+                buffer->size = cut;
+                publishBuffer(ring, idx);
+                idx = nextIdx;
+                buffer = next;
+            }
+
+            // Read the file
+            bytesRead = read(fd, buffer->data + buffer->size,
+                             buffer->capacity - buffer->size);
+            if (bytesRead < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytesRead <= 0) {
+                break;
+            }
+            buffer->size += bytesRead;
+        }
+        // A file that cannot be read counts up to the error, while no memory
+        // left stops the reader
+        if (bytesRead < 0) {
+            perror("Error while reading file in readerThread.\n");
+            statusReader = EXIT_FAILURE;
+        }
+        close(fd);
+        if (buffer->size == buffer->capacity) {
+            perror("Error while allocating memory in readerThread.\n");
+            statusReader = EXIT_FAILURE;
+            break;
+        }
+
+        // Publish the end of the file
+        if (buffer->size > 0) {
+            publishBuffer(ring, idx);
+            idx = acquireBuffer(ring);
+            buffer = &ring->buffers[idx];
+        }
+    }
+    releaseChunk(ring, idx);
+    atomic_store(&ring->done, true);
+    pthread_exit(&statusReader);
+}
+
+bool startChunkRing(struct chunkRing* ring, int depth, size_t chunkSize,
+                    int numFiles, char** filenames, struct arena* arena) {
+    // The reader holds a full buffer while moving its last word to the next one
+    if (depth < MINRINGDEPTH) {
+        depth = MINRINGDEPTH;
+    }
+    ring->depth = depth;
+    ring->numFiles = numFiles;
+    ring->filenames = filenames;
+    atomic_init(&ring->done, false);
+    atomic_init(&ring->numChunks, 0);
+    atomic_init(&ring->producerStalls, 0);
+    atomic_init(&ring->consumerStalls, 0);
+    initBufferPool(&ring->pool, arena, chunkSize);
+    if ((ring->buffers = arenaAlloc(arena, sizeof(struct chunkBuffer) *
+                                               depth)) == NULL ||
+        !initQueue(&ring->filled, depth, arena) ||
+        !initQueue(&ring->empty, depth, arena)) {
+        return false;
+    }
+    for (int i = 0; i < depth; i++) {
+        if ((ring->buffers[i].data = acquirePoolBuffer(&ring->pool)) == NULL) {
+            return false;
+        }
+        ring->buffers[i].capacity = ring->pool.bufferSize;
+        pushQueue(&ring->empty, i);
+    }
+    return pthread_create(&ring->reader, NULL, readerThread, ring) == 0;
+}
+
+int popChunk(struct chunkRing* ring) {
+    bool stalled = false;
+    double idle = 0;
+    int idx;
+
+    while (!popQueue(&ring->filled, &idx)) {
+        // The last buffers may have been published right before the end
+        if (atomic_load(&ring->done)) {
+            idx = popQueue(&ring->filled, &idx) ? idx : -1;
+            break;
+        }
+        if (!stalled) {
+            stalled = true;
+            idle = traceMark();
+            atomic_fetch_add(&ring->consumerStalls, 1);
+        }
+        sched_yield();
+    }
+    if (stalled) {
+        traceSpan("idle", idle);
+    }
+    return idx;
+}
+
+void releaseChunk(struct chunkRing* ring, int idx) {
+    // Never full: the queue holds as many cells as there are buffers
+    pushQueue(&ring->empty, idx);
+}
+
+int stopChunkRing(struct chunkRing* ring) {
+    int* status_p;
+
+    if (pthread_join(ring->reader, (void*)&status_p) != 0) {
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < ring->depth; i++) {
+        if (ring->buffers[i].capacity == ring->pool.bufferSize) {
+            releasePoolBuffer(&ring->pool, ring->buffers[i].data);
+        }
+    }
+    return *status_p;
+}
+
+void printChunkRingStats(struct chunkRing* ring) {
+    printf("Pipeline: depth %d, %ld chunks, %ld producer stalls, %ld consumer "
+           "stalls.\n",
+           ring->depth, atomic_load(&ring->numChunks),
+           atomic_load(&ring->producerStalls),
+           atomic_load(&ring->consumerStalls));
+    printPoolStats("Pipeline chunk", &ring->pool);
+}
@@ -0,0 +1,173 @@
+/**
+ *  \file chunkRing.h (interface file)
+ *
+ *  \brief Pipeline feeding the workers from a dedicated reader thread.
+ *
+ *  The reader thread reads the files into a fixed set of preallocated chunk
+ * buffers, cut right after a delimiter, and publishes the filled buffers in a
+ * bounded lock-free queue; workers pop them from it and give them back through
+ * a second queue once processed. Reading therefore overlaps with processing,
+ * and neither side ever takes a lock: a side that finds its queue empty spins
+ * (yielding the processor) and the episode is counted as a stall.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef CHUNKRING_H
+#define CHUNKRING_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../common/arena.h"
+#include "../common/bufferPool.h"
+#include "../common/histogram.h"
+
+/**
+ *  \brief structure containing a text buffer filled by the reader thread.
+ */
+struct chunkBuffer {
+    /** \brief text read (not null-terminated). */
+    char* data;
+
+    /** \brief memory space (number of bytes) of 'data'. */
+    size_t capacity;
+
+    /** \brief number of bytes of 'data' in use. */
+    size_t size;
+
+    /** \brief identifier of the file the text belongs to. */
+    int fileId;
+};
+
+/**
+ *  \brief structure containing a cell of a bounded queue.
+ */
+struct ringCell {
+    /** \brief sequence number telling whether the cell is free or filled. */
+    atomic_size_t sequence;
+
+    /** \brief index of the buffer stored in the cell. */
+    int value;
+};
+
+/**
+ *  \brief structure containing a bounded lock-free queue of buffer indices
+ * (Vyukov's array-based queue, safe for any number of producers and
+ * consumers).
+ */
+struct ringQueue {
+    /** \brief cells of the queue (a power of 2). */
+    struct ringCell* cells;
+
+    /** \brief number of cells minus one. */
+    size_t mask;
+
+    /** \brief position of the next push. */
+    _Alignas(CACHELINESIZE) atomic_size_t head;
+
+    /** \brief position of the next pop. */
+    _Alignas(CACHELINESIZE) atomic_size_t tail;
+};
+
+/**
+ *  \brief structure containing the state of the pipeline.
+ */
+struct chunkRing {
+    /** \brief chunk buffers shared by the reader and the workers. */
+    struct chunkBuffer* buffers;
+
+    /** \brief number of chunk buffers (depth of the ring). */
+    int depth;
+
+    /** \brief buffers filled by the reader, waiting for a worker. */
+    struct ringQueue filled;
+
+    /** \brief buffers processed by the workers, waiting for the reader. */
+    struct ringQueue empty;
+
+    /** \brief paths to the files to read. */
+    char** filenames;
+
+    /** \brief number of files to read. */
+    int numFiles;
+
+    /** \brief whether the reader has published its last buffer. */
+    atomic_bool done;
+
+    /** \brief number of buffers published by the reader. */
+    atomic_long numChunks;
+
+    /** \brief number of times the reader waited for an empty buffer. */
+    atomic_long producerStalls;
+
+    /** \brief number of times a worker waited for a filled buffer. */
+    atomic_long consumerStalls;
+
+    /** \brief pool the chunk buffers are taken from (only used by the reader
+     * while the pipeline runs). */
+    struct bufferPool pool;
+
+    /** \brief reader thread. */
+    pthread_t reader;
+};
+
+/**
+ *  \brief Start of the pipeline.
+ *
+ *  Takes the chunk buffers from a pool and launches the reader thread. A
+ * buffer grown to hold a long word is taken from the arena directly.
+ *
+ *  \param ring pipeline to start.
+ *  \param depth number of chunk buffers (2 at least).
+ *  \param chunkSize memory space (number of bytes) of each chunk buffer.
+ *  \param numFiles number of files to read.
+ *  \param filenames paths to the files to read.
+ *  \param arena arena holding the memory of the pipeline.
+ *
+ *  \return false if memory could not be allocated or the reader could not be
+ * launched.
+ */
+extern bool startChunkRing(struct chunkRing* ring, int depth, size_t chunkSize,
+                           int numFiles, char** filenames, struct arena* arena);
+
+/**
+ *  \brief Retrieval of the next filled buffer.
+ *
+ *  \param ring pipeline.
+ *
+ *  \return index of the buffer (-1 once every file has been handed out).
+ */
+extern int popChunk(struct chunkRing* ring);
+
+/**
+ *  \brief Return of a processed buffer to the reader.
+ *
+ *  \param ring pipeline.
+ *  \param idx index of the buffer.
+ *
+ */
+extern void releaseChunk(struct chunkRing* ring, int idx);
+
+/**
+ *  \brief Stop of the pipeline.
+ *
+ *  Waits for the reader thread and gives the chunk buffers back to the pool.
+ *
+ *  \param ring pipeline to stop.
+ *
+ *  \return exit status of the reader thread.
+ */
+extern int stopChunkRing(struct chunkRing* ring);
+
+/**
+ *  \brief Presentation of the statistics of the pipeline.
+ *
+ *  \param ring pipeline.
+ *
+ */
+extern void printChunkRingStats(struct chunkRing* ring);
+
+#endif /* CHUNKRING_H */
@@ -7,6 +7,7 @@
  */
 
 #include "wordCount.h"
+#include "../common/histogram.h"
 
 #ifndef CONTROLINFO_H
 #define CONTROLINFO_H
@@ -16,21 +17,20 @@
  */
 struct controlInfo {
 
-    /** \brief array containing the results of the occurrence frequence for each word size. */
-    int wordSize[MAXSIZE];
-
-    /** \brief 2D array containing the results of the vowels count for each word size. */
-    int vowelCount[MAXSIZE][MAXSIZE];
-
-    /** \brief maximum size possible for a word. */
-    int maxWordSize;
-
-    /** \brief maximum number of vowels in a word. */
-    int maxVowelCount;
+    /** \brief occurrence frequencies of word sizes and vowel counts (wordSize[], vowelCount[][], maxWordSize, maxVowelCount) found by the worker in the current file. */
+    struct histogram* histogram;
 
     /** \brief identifier of the current file under processing. */
     int fileId;
 
+    /** \brief current text chunk under processing (a range of the file's mapping
+     * or of a buffer of the reading pipeline, never copied nor
+     * null-terminated). */
+    const char* text;
+
+    /** \brief size (number of bytes) of the current text chunk. */
+    size_t textSize;
+
 };
 
 #endif /* CONTROLINFO_H */
\ No newline at end of file
@@ -7,6 +7,7 @@
  *  Threads synchronization is based on monitors. Both threads and the monitor are implemented using the pthread library which enables the creation of a monitor of the Lampson / Redell type.
  *  Definition of the operations carried out by the workers:
  *     \li getTextChunk
+ *     \li getPartialResults
  *     \li savePartialResults
  *     \li presentFilenames
  *     \li printResults.
@@ -18,6 +19,8 @@
 #define TEXTPROC_H
 
 #include "chunk.h"
+#include "../common/histogram.h"
+#include "../common/resultWriter.h"
 
 /** 
  *  \brief Retrieval of a portion of text (called text chunk).
@@ -29,23 +32,27 @@
  */
 extern struct Chunk getTextChunk(int workerId);
 
+/** 
+ *  \brief Retrieval of the results of a worker for a file.
+ * 
+ *  Every worker accumulates the results of its text chunks in its own histogram of each file, so no lock is taken while text is processed.
+ * 
+ *  \param workerId internal worker thread identifier.
+ *  \param fileId identifier of the file.
+ * 
+ *  \return histogram of the worker for the file.
+ */
+extern struct histogram* getPartialResults(int workerId, int fileId);
+
 /** 
  *  \brief Update of global results.
  * 
- *  Monitor updates the global results with the results achieved by the worker that called the method.
+ *  Called once by every worker, after its last text chunk. The histograms of all workers are merged through a parallel tree reduction, and the worker left with the merged results updates the global results.
  * 
  *  \param workerId internal worker thread identifier.
- *  \param fileId identifier of the file whose chunk results are being saved.
- *  \param wordSize array containing the number of words found whose size is equal to the respective index.
- *  \param wordSizeSize size of the 'wordSize' array.
- *  \param vowelCount 2D array containing the number of words found whose number of vowels and word size are equal to x and y.
- *  \param vowelCountSizeX size of the 1st dimension of 'vowelCount' array.
- *  \param vowelCountSizeY size of the 2nd dimension of 'vowelCount' array.
  * 
  */
-extern void savePartialResults(int workerId, int fileId, int* wordSize,
-                               int wordSizeSize, int** vowelCount,
-                               int vowelCountSizeX, int vowelCountSizeY);
+extern void savePartialResults(int workerId);
 
 /** 
  *  \brief Presentation of all the files to be processed.
@@ -61,17 +68,20 @@ extern void presentFilenames(int size, char** filenames);
 /** 
  *  \brief Presentation of the global results achieved by all worker threads.
  * 
- *  Monitor prints in a formatted form the results of the 'wordCount' program execution.
+ *  Monitor writes the results of the 'wordCount' program execution, file by file, in the format of the writer.
+ * 
+ *  \param writer writer of the results.
  * 
  */
-extern void printResults();
+extern void printResults(struct resultWriter* writer);
 
 /** 
  *  \brief Destruction of monitor variables.
  * 
  *  Monitor frees memory allocated for its variables.
  * 
+ *  \return EXIT_FAILURE if a file could not be read.
  */
-extern void destroy();
+extern int destroy();
 
 #endif /* TEXTPROC_H */
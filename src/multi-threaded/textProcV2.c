@@ -19,29 +19,50 @@
 #include <errno.h>
 #include <limits.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include "chunkRing.h"
 #include "controlInfo.h"
 #include "wordCount.h"
-
-/** \brief array containing all the characters defined as word delimiters */
-char delimiters[25][MAXCHARSIZE] = {
-    " ", "-", "–", "—",  ".",  ",",  ":",  ";", "(", ")", "[", "]", "{",
-    "}", "?", "!", "\n", "\t", "\r", "\"", "“", "”", "«", "»", "…"};
+#include "workDeque.h"
+#include "workerStats.h"
+#include "../common/arena.h"
+#include "../common/chunkPolicy.h"
+#include "../common/inputMap.h"
+#include "../common/results.h"
+#include "../common/resultWriter.h"
+#include "../common/textScan.h"
+#include "../common/trace.h"
 
 /** \brief worker threads return status array */
-extern int statusWorker[NUMWORKERS];
+extern int* statusWorker;
+
+/** \brief number of worker threads */
+extern int numWorkers;
+
+/** \brief largest size (number of bytes) of a text chunk */
+extern size_t chunkSize;
+
+/** \brief number of chunk buffers of the reading pipeline (0 if the files are
+ * mapped instead) */
+extern int ringDepth;
+
+/** \brief largest number of files not fully claimed at the same time */
+extern int maxFilesInFlight;
 
 /** \brief main thread return status value */
 extern int statusMain;
 
 /** \brief boolean defining wether files have been read and monitor is ready for
  * use or not */
-bool areFilenamesPresented;
+atomic_bool areFilenamesPresented;
 
 pthread_mutex_t accessCR = PTHREAD_MUTEX_INITIALIZER;
 
@@ -49,20 +70,29 @@ pthread_once_t init = PTHREAD_ONCE_INIT;
 
 pthread_cond_t filenamesPresented;
 
-char tmpWord[MAXSIZE];
-FILE** files;
+/** \brief barrier separating the steps of the reduction of the workers'
+ * results */
+pthread_barrier_t mergeStep;
+
+/** \brief memory held for the whole run (released by 'destroy') */
+struct arena runArena;
+
+struct inputMap* inputs;
+struct workDeque* deques;
+unsigned int* stealSeeds;
+atomic_size_t bytesLeft;
+int* fileOrder;
+atomic_size_t* fileBytesLeft;
+atomic_int nextFile = 0;
+atomic_int filesInFlight = 0;
+atomic_int filesOpened = 0;
+struct chunkPolicy chunkPolicy;
+struct histogram** workerHistograms;
 char** filenames;
-int** wordSizeResults;
-int*** vowelCountResults;
-int* numberWordsResults;
-int* maximumSizeWordResults;
-int* minimumSizeWordResults;
+struct results results;
 int filesSize;
-int currentFileIdx = 0;
-char symbol;
-char completeSymbol[MAXCHARSIZE];  // buffer for complex character construction
-int ones;
-bool incrementFileIdx;
+struct chunkRing chunkRing;
+int* heldChunk;
 
 /**
  *  \brief Monitor initialization.
@@ -71,29 +101,261 @@ bool incrementFileIdx;
  *
  */
 void initialization(void) {
-    strcpy(tmpWord, "");
-    incrementFileIdx = false;
-
     pthread_cond_init(&filenamesPresented, NULL);
+    pthread_barrier_init(&mergeStep, NULL, numWorkers);
+    initArena(&runArena, ARENABLOCKSIZE);
+    initChunkPolicy(&chunkPolicy, chunkSize, numWorkers);
     printf("Monitor initialized.\n");
 }
 
 /**
- *  \brief Retrieval of a portion of text (called text chunk).
+ *  \brief Comparison of two files by decreasing size (then by position).
  *
- *  Monitor retrieves a portion of text (called text chunk) and assigns its
- * processing for the worker that called the method.
+ *  \param a pointer to the identifier of the first file.
+ *  \param b pointer to the identifier of the second file.
+ *
+ *  \return negative if the first file goes first, positive otherwise.
+ */
+static int largestFirst(const void* a, const void* b) {
+    int fileA = *(const int*)a;
+    int fileB = *(const int*)b;
+    size_t sizeA = atomic_load(&fileBytesLeft[fileA]);
+    size_t sizeB = atomic_load(&fileBytesLeft[fileB]);
+
+    if (sizeA != sizeB) {
+        return sizeA > sizeB ? -1 : 1;
+    }
+    return fileA - fileB;
+}
+
+/**
+ *  \brief Scheduling of the files presented.
+ *
+ *  The files are only looked up here: their sizes give the order in which the
+ * workers open them (largest first) and the number of bytes left to claim.
+ * Every worker gets an empty deque.
+ *
+ *  \return false if a file could not be found or memory could not be
+ * allocated.
+ */
+static bool scheduleFiles(void) {
+    struct stat info;
+
+    deques = arenaAlloc(&runArena, sizeof(struct workDeque) * numWorkers);
+    stealSeeds = arenaAlloc(&runArena, sizeof(unsigned int) * numWorkers);
+    fileOrder = arenaAlloc(&runArena, sizeof(int) * filesSize);
+    fileBytesLeft = arenaAlloc(&runArena, sizeof(atomic_size_t) * filesSize);
+    if (deques == NULL || stealSeeds == NULL || fileOrder == NULL ||
+        fileBytesLeft == NULL) {
+        errno = ENOMEM;
+        return false;
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        // A worker is dealt one range of each file at most, while the rests
+        // of the ranges stolen from others (one per thief at a time) may be
+        // pushed alongside them
+        if (!initWorkDeque(&deques[i], filesSize + numWorkers, &runArena)) {
+            return false;
+        }
+        stealSeeds[i] = (unsigned int)random();
+    }
+    atomic_init(&bytesLeft, 0);
+    for (int i = 0; i < filesSize; i++) {
+        if (stat(filenames[i], &info) == -1) {
+            return false;
+        }
+        // Only regular files tell their size before being read
+        size_t size = S_ISREG(info.st_mode) ? (size_t)info.st_size : 0;
+        atomic_init(&fileBytesLeft[i], size);
+        atomic_fetch_add(&bytesLeft, size);
+        fileOrder[i] = i;
+    }
+    qsort(fileOrder, filesSize, sizeof(int), largestFirst);
+    return true;
+}
+
+/**
+ *  \brief Opening of the next file to process.
+ *
+ *  A file is opened only while fewer than 'maxFilesInFlight' files are not
+ * fully claimed, so that several workers open, read and scan different files
+ * at the same time. The file is split into at most one range per worker (no
+ * smaller than the smallest chunk size), dealt to the deques starting from the
+ * worker that opened it.
  *
  *  \param workerId internal worker thread identifier.
- *  \param textChunk portion of text to be processed by the worker.
- *  \param controlInfo structure containing control variables regarding the
- * results of the worker.
  *
+ *  \return false if no file may be opened now.
  */
-bool getTextChunk(int workerId, char* textChunk,
-                  struct controlInfo controlInfo) {
+static bool openNextFile(int workerId) {
+    int inFlight = atomic_load(&filesInFlight);
+    int order;
+
+    // Take a place among the files in flight, then the next file
+    do {
+        if (inFlight >= maxFilesInFlight ||
+            atomic_load(&nextFile) >= filesSize) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak(&filesInFlight, &inFlight,
+                                            inFlight + 1));
+    if ((order = atomic_fetch_add(&nextFile, 1)) >= filesSize) {
+        atomic_fetch_sub(&filesInFlight, 1);
+        return false;
+    }
+
+    // Map the file into memory (a file that cannot be read counts as empty)
+    int fileId = fileOrder[order];
+    size_t expected = atomic_load(&fileBytesLeft[fileId]);
+    if (!mapInput(filenames[fileId], &inputs[fileId])) {
+        perror("Error while opening file in openNextFile.\n");
+        unmapInput(&inputs[fileId]);
+        inputs[fileId].size = 0;
+    }
+    size_t size = inputs[fileId].size;
+    atomic_store(&fileBytesLeft[fileId], size);
+    atomic_fetch_add(&bytesLeft, size);
+    atomic_fetch_sub(&bytesLeft, expected);
+
+    // Deal its ranges to the workers
+    size_t numRanges = size / chunkPolicy.minSize;
+    if (numRanges > (size_t)numWorkers) {
+        numRanges = numWorkers;
+    } else if (numRanges == 0) {
+        numRanges = 1;
+    }
+    for (size_t j = 0; j < numRanges && size > 0; j++) {
+        struct textRange range = {fileId, size * j / numRanges,
+                                  size * (j + 1) / numRanges};
+        // A full deque passes the range on to the next one (waiting for
+        // room if all are full)
+        for (int k = 0; !pushRange(&deques[(workerId + j + k) % numWorkers],
+                                   range);
+             k++) {
+            if ((k + 1) % numWorkers == 0) {
+                sched_yield();
+            }
+        }
+    }
+    if (size == 0) {
+        atomic_fetch_sub(&filesInFlight, 1);
+    }
+    atomic_fetch_add(&filesOpened, 1);
+    return true;
+}
+
+/**
+ *  \brief Claim of the next range of text of the files presented.
+ *
+ *  The worker takes the newest range of its own deque or, once it is empty,
+ * opens the next file or steals the oldest range of another worker. A block
+ * sized by the chunk size policy (from the number of bytes not yet claimed) is
+ * split off the start of the range and the rest goes back to the worker's
+ * deque. Both ends of the block are then moved forward to the next word
+ * boundary; the same fixup is applied to the neighbouring blocks, so
+ * consecutive ranges never overlap nor split a word, and the file they belong
+ * to travels with them.
+ *
+ *  \param workerId internal worker thread identifier.
+ *  \param text first byte of the range claimed.
+ *  \param textSize size (number of bytes) of the range claimed.
+ *
+ *  \return identifier of the file the range belongs to (-1 if no text is left).
+ */
+static int claimTextRange(int workerId, const char** text, size_t* textSize) {
+    struct workDeque* own = &deques[workerId];
+    struct textRange range;
+
+    for (;;) {
+        // Take a range, waiting for the ones being split by other workers
+        if (!popRange(own, &range)) {
+            if (openNextFile(workerId)) {
+                continue;
+            }
+            if (!stealRange(deques, numWorkers, workerId,
+                            &stealSeeds[workerId], &range)) {
+                if (atomic_load(&filesOpened) == filesSize &&
+                    atomic_load(&bytesLeft) == 0) {
+                    return -1;
+                }
+                sched_yield();
+                continue;
+            }
+        }
+
+        // Split the block off the range, keeping the rest for later (the
+        // whole range is claimed if the deque has no room for the rest)
+        size_t size = nextChunkSize(&chunkPolicy, atomic_load(&bytesLeft));
+        if (size < range.end - range.start) {
+            struct textRange rest = {range.fileId, range.start + size,
+                                     range.end};
+            if (pushRange(own, rest)) {
+                range.end = range.start + size;
+            }
+        }
+        atomic_fetch_sub(&bytesLeft, range.end - range.start);
+        if (atomic_fetch_sub(&fileBytesLeft[range.fileId],
+                             range.end - range.start) ==
+            range.end - range.start) {
+            atomic_fetch_sub(&filesInFlight, 1);
+        }
+
+        // Adjust both ends of the range to word boundaries (a range lying
+        // inside a single word is left for the worker that claimed its start)
+        struct inputMap* map = &inputs[range.fileId];
+        size_t end = nextWordBoundary(map->data, map->size, range.end);
+        size_t start = nextWordBoundary(map->data, map->size, range.start);
+        if (start < end) {
+            *text = map->data + start;
+            *textSize = end - start;
+            return range.fileId;
+        }
+    }
+}
+
+/**
+ *  \brief Claim of the next text chunk filled by the reader thread.
+ *
+ *  The chunk buffer previously held by the worker is given back to the reader
+ * first.
+ *
+ *  \param workerId internal worker thread identifier.
+ *  \param text first byte of the text chunk.
+ *  \param textSize size (number of bytes) of the text chunk.
+ *
+ *  \return identifier of the file the text chunk belongs to (-1 if no text is
+ * left).
+ */
+static int claimRingChunk(int workerId, const char** text, size_t* textSize) {
+    struct chunkBuffer* buffer;
+
+    if (heldChunk[workerId] >= 0) {
+        releaseChunk(&chunkRing, heldChunk[workerId]);
+    }
+    if ((heldChunk[workerId] = popChunk(&chunkRing)) < 0) {
+        return -1;
+    }
+    buffer = &chunkRing.buffers[heldChunk[workerId]];
+    *text = buffer->data;
+    *textSize = buffer->size;
+    return buffer->fileId;
+}
+
+/**
+ *  \brief Wait for the files to be presented.
+ *
+ *  Only the calls made before the files are presented enter the monitor.
+ *
+ *  \param workerId internal worker thread identifier.
+ *
+ */
+static void waitFilenamesPresented(int workerId) {
+    if (atomic_load(&areFilenamesPresented)) {
+        return;
+    }
+
     // Enter monitor
-    if ((statusWorker[workerId] = pthread_mutex_lock(&accessCR)) != 0) {
+    if ((statusWorker[workerId] = lockCounted(&accessCR)) != 0) {
         errno = statusWorker[workerId];
         perror("Error on entering monitor(CF).\n");
         statusWorker[workerId] = EXIT_FAILURE;
@@ -102,6 +364,7 @@ bool getTextChunk(int workerId, char* textChunk,
     pthread_once(&init, initialization);
 
     // Wait for files to be read
+    double idle = traceMark();
     while (!areFilenamesPresented) {
         if ((statusWorker[workerId] =
                  pthread_cond_wait(&filenamesPresented, &accessCR)) != 0) {
@@ -111,100 +374,129 @@ bool getTextChunk(int workerId, char* textChunk,
             pthread_exit(&statusWorker[workerId]);
         }
     }
-    bool stillExistsText;
-
-    strcat(textChunk, tmpWord);
-    strcpy(tmpWord, "");
-    if (currentFileIdx < filesSize) {
-        while (strlen(textChunk) < BUFFERSIZE) {
-            symbol = getc(files[currentFileIdx]);
+    traceSpan("idle", idle);
 
-            // Verify if the current file has ended
-            if (symbol == EOF) {
-                if (strlen(tmpWord) + strlen(textChunk) < BUFFERSIZE) {
-                    strcat(textChunk, tmpWord);
-                    strcpy(tmpWord, "");
-                }
-                incrementFileIdx = true;
-                break;
-            }
-            strcpy(completeSymbol, "");
-            ones = 0;
-
-            // Verify the number of 1s in the most significant bits
-            for (int i = sizeof(symbol) * CHAR_BIT - 1; i >= 0; --i) {
-                int bit = (symbol >> i) & 1;
-                if (bit == 0) {
-                    break;
-                }
-                ones++;
-            }
-
-            // Build the complete character (if it consists of more than 1byte)
-            strncat(completeSymbol, &symbol, 1);
-            for (int i = 1; i < ones; i++) {
-                symbol = getc(files[currentFileIdx]);
-                strncat(completeSymbol, &symbol, 1);
-            }
-
-            // Check if character is a delimiter
-            bool leaveLoop = false;
-            for (int i = 0; i < sizeof(delimiters) / sizeof(delimiters[0]);
-                 i++) {
-                if (strcmp(completeSymbol, delimiters[i]) == 0) {
-                    if (strlen(tmpWord) + strlen(textChunk) < BUFFERSIZE) {
-                        strcat(textChunk, tmpWord);
-                        strcpy(tmpWord, "");
-                    } else {
-                        leaveLoop = true;
-                    }
-                    break;
-                }
-            }
+    // Leave monitor
+    if ((statusWorker[workerId] = unlockCounted(&accessCR)) != 0) {
+        errno = statusWorker[workerId];
+        perror("Error on exiting monitor(CF).\n");
+        statusWorker[workerId] = EXIT_FAILURE;
+        pthread_exit(&statusWorker[workerId]);
+    }
+}
 
-            strcat(tmpWord, completeSymbol);
-            if (leaveLoop) {
-                break;
-            }
+/**
+ *  \brief Histogram of a worker for a file.
+ *
+ *  Histograms are taken from the run arena on the first text chunk of the file
+ * processed by
+ * the worker, so memory grows with the files each worker actually touches.
+ *
+ *  \param workerId internal worker thread identifier.
+ *  \param fileId identifier of the file.
+ *
+ *  \return histogram of the worker for the file.
+ */
+static struct histogram* workerHistogram(int workerId, int fileId) {
+    struct histogram** hist = &workerHistograms[workerId * filesSize + fileId];
+
+    if (*hist == NULL) {
+        if ((*hist = arenaAlloc(&runArena, sizeof(struct histogram))) ==
+            NULL) {
+            errno = ENOMEM;
+            perror("Error while allocating memory in workerHistogram.\n");
+            statusWorker[workerId] = EXIT_FAILURE;
+            pthread_exit(&statusWorker[workerId]);
         }
+        initHistogram(*hist);
     }
+    return *hist;
+}
 
-    controlInfo.fileId = currentFileIdx;
-    if (strlen(textChunk) <= 0) {
-        stillExistsText = false;
+/**
+ *  \brief Retrieval of a portion of text (called text chunk).
+ *
+ *  Monitor retrieves a portion of text (called text chunk) and assigns its
+ * processing for the worker that called the method. The text chunk is a range
+ * of a file's mapping, claimed without entering the monitor.
+ *
+ *  \param workerId internal worker thread identifier.
+ *  \param controlInfo structure containing control variables regarding the
+ * results of the worker (receives the text chunk, its file and the worker's
+ * histogram of that file).
+ *
+ */
+bool getTextChunk(int workerId, struct controlInfo* controlInfo) {
+    waitFilenamesPresented(workerId);
+
+    // Retrieve text chunk from current file
+    controlInfo->text = NULL;
+    controlInfo->textSize = 0;
+    if (ringDepth > 0) {
+        controlInfo->fileId = claimRingChunk(workerId, &controlInfo->text,
+                                             &controlInfo->textSize);
     } else {
-        stillExistsText = true;
+        controlInfo->fileId = claimTextRange(workerId, &controlInfo->text,
+                                             &controlInfo->textSize);
     }
-
-    if (incrementFileIdx) {
-        currentFileIdx++;
-        incrementFileIdx = false;
-    }
-
-    // Leave monitor
-    if ((statusWorker[workerId] = pthread_mutex_unlock(&accessCR)) != 0) {
-        errno = statusWorker[workerId];
-        perror("Error on exiting monitor(CF).\n");
-        statusWorker[workerId] = EXIT_FAILURE;
-        pthread_exit(&statusWorker[workerId]);
+    if (controlInfo->textSize == 0) {
+        return false;
     }
-    return stillExistsText;
+    controlInfo->histogram = workerHistogram(workerId, controlInfo->fileId);
+    return true;
 }
 
 /**
  *  \brief Update of global results.
  *
- *  Monitor updates the global results with the results achieved by the worker
- * that called the method.
+ *  Called once by every worker, after its last text chunk. The histograms of
+ * all workers are merged through a parallel tree reduction: at each step, every
+ * worker still holding results adds those of a partner to its own. The worker
+ * left with the merged results updates the global results, entering the
+ * monitor once for the whole run.
  *
  *  \param workerId internal worker thread identifier.
- *  \param controlInfo structure containing control variables regarding the
- * results of the worker.
  *
  */
-void savePartialResults(int workerId, struct controlInfo controlInfo) {
+void savePartialResults(int workerId) {
+    struct histogram** own = &workerHistograms[workerId * filesSize];
+
+    for (int step = 1; step < numWorkers; step *= 2) {
+        // Wait for the previous step to be completed by all workers
+        double idle = traceMark();
+        statusWorker[workerId] = pthread_barrier_wait(&mergeStep);
+        traceSpan("idle", idle);
+        if (statusWorker[workerId] != 0 &&
+            statusWorker[workerId] != PTHREAD_BARRIER_SERIAL_THREAD) {
+            errno = statusWorker[workerId];
+            perror("Error on waiting in mergeStep.\n");
+            statusWorker[workerId] = EXIT_FAILURE;
+            pthread_exit(&statusWorker[workerId]);
+        }
+
+        // Merge the results of the partner of this step
+        if (workerId % (2 * step) == 0 && workerId + step < numWorkers) {
+            struct histogram** partner =
+                &workerHistograms[(workerId + step) * filesSize];
+            for (int i = 0; i < filesSize; i++) {
+                if (partner[i] == NULL) {
+                    continue;
+                }
+                if (own[i] == NULL) {
+                    own[i] = partner[i];
+                    partner[i] = NULL;
+                } else {
+                    mergeHistogram(own[i], partner[i]);
+                }
+            }
+        }
+    }
+    if (workerId != 0) {
+        return;
+    }
+
     // Enter monitor
-    if ((statusWorker[workerId] = pthread_mutex_lock(&accessCR)) != 0) {
+    if ((statusWorker[workerId] = lockCounted(&accessCR)) != 0) {
         errno = statusWorker[workerId];
         perror("Error on entering monitor(CF).\n");
         statusWorker[workerId] = EXIT_FAILURE;
@@ -213,27 +505,14 @@ void savePartialResults(int workerId, struct controlInfo controlInfo) {
     pthread_once(&init, initialization);
 
     // Update global counts
-    for (int i = 0; i < controlInfo.maxWordSize; i++) {
-        wordSizeResults[controlInfo.fileId][i] += controlInfo.wordSize[i];
-        numberWordsResults[controlInfo.fileId] += controlInfo.wordSize[i];
-        if (i > maximumSizeWordResults[controlInfo.fileId] &&
-            controlInfo.wordSize[i] > 0) {
-            maximumSizeWordResults[controlInfo.fileId] = i;
-        }
-        if (i < minimumSizeWordResults[controlInfo.fileId] &&
-            controlInfo.wordSize[i] > 0) {
-            minimumSizeWordResults[controlInfo.fileId] = i;
-        }
-    }
-    for (int i = 0; i < controlInfo.maxVowelCount; i++) {
-        for (int j = 0; j < controlInfo.maxWordSize; j++) {
-            vowelCountResults[controlInfo.fileId][i][j] +=
-                controlInfo.vowelCount[i][j];
+    for (int i = 0; i < filesSize; i++) {
+        if (own[i] != NULL) {
+            addHistogram(&results, i, own[i]);
         }
     }
 
     // Leave monitor
-    if ((statusWorker[workerId] = pthread_mutex_unlock(&accessCR)) != 0) {
+    if ((statusWorker[workerId] = unlockCounted(&accessCR)) != 0) {
         errno = statusWorker[workerId];
         perror("Error on exiting monitor(CF).\n");
         statusWorker[workerId] = EXIT_FAILURE;
@@ -266,54 +545,43 @@ void presentFilenames(int size, char** fileNames) {
         filenames = fileNames;
 
         // Allocate memory
-        if ((files = malloc(sizeof(FILE*) * (filesSize))) == NULL) {
+        inputs = arenaAlloc(&runArena, sizeof(struct inputMap) * filesSize);
+        workerHistograms = arenaAlloc(
+            &runArena, sizeof(struct histogram*) * numWorkers * filesSize);
+        if (inputs == NULL || workerHistograms == NULL) {
             errno = statusMain;
             perror("Error while allocating memory in presentFilenames.\n");
             statusMain = EXIT_FAILURE;
             pthread_exit(&statusMain);
         }
-        wordSizeResults = malloc(sizeof(int*) * (filesSize));
-        vowelCountResults = malloc(sizeof(int*) * (filesSize));
-        maximumSizeWordResults = malloc(sizeof(int) * (filesSize));
-        minimumSizeWordResults = malloc(sizeof(int) * (filesSize));
-        numberWordsResults = malloc(sizeof(int) * (filesSize));
-        if (wordSizeResults == NULL || vowelCountResults == NULL ||
-            maximumSizeWordResults == NULL || minimumSizeWordResults == NULL ||
-            numberWordsResults == NULL) {
+        if (!allocResults(&results, filesSize, HISTSIZE)) {
             errno = statusMain;
             perror("Error while allocating memory in presentFilenames.\n");
             statusMain = EXIT_FAILURE;
             pthread_exit(&statusMain);
         }
-
         // Process files given as input
-        for (int i = 0; i < size; i++) {
-            maximumSizeWordResults[i] = 0;
-            minimumSizeWordResults[i] = MAXSIZE;
-            numberWordsResults[i] = 0;
-            wordSizeResults[i] = malloc(sizeof(int) * (MAXSIZE));
-            vowelCountResults[i] = malloc(sizeof(int*) * (MAXSIZE));
-            if (wordSizeResults[i] == NULL || vowelCountResults[i] == NULL) {
-                errno = statusMain; /* save error in errno */
-                perror("Error while allocating memory in presentFilenames.\n");
+        if (ringDepth > 0) {
+            // Start reading the files into the chunk buffers
+            heldChunk = arenaAlloc(&runArena, sizeof(int) * numWorkers);
+            if (heldChunk == NULL ||
+                !startChunkRing(&chunkRing, ringDepth, chunkSize, filesSize,
+                                filenames, &runArena)) {
+                errno = statusMain;
+                perror("Error while reading files in presentFilenames.\n");
                 statusMain = EXIT_FAILURE;
                 pthread_exit(&statusMain);
             }
-            for (int j = 0; j < MAXSIZE; j++) {
-                wordSizeResults[i][j] = 0;
-                if ((vowelCountResults[i][j] =
-                         malloc(sizeof(int) * (MAXSIZE))) == NULL) {
-                    errno = statusMain; /* save error in errno */
-                    perror(
-                        "Error while allocating memory in presentFilenames.\n");
-                    statusMain = EXIT_FAILURE;
-                    pthread_exit(&statusMain);
-                }
-                for (int l = 0; l < MAXSIZE; l++) {
-                    vowelCountResults[i][j][l] = 0;
-                }
+            for (int i = 0; i < numWorkers; i++) {
+                heldChunk[i] = -1;
+            }
+        } else {
+            // Leave the files to be opened by the workers
+            if (!scheduleFiles()) {
+                perror("Error while opening file in presentFilenames.\n");
+                statusMain = EXIT_FAILURE;
+                pthread_exit(&statusMain);
             }
-            files[i] = fopen(filenames[i], "r");
         }
         areFilenamesPresented = true;
         printf("Files presented.\n");
@@ -339,11 +607,13 @@ void presentFilenames(int size, char** fileNames) {
 /**
  *  \brief Presentation of the global results achieved by all worker threads.
  *
- *  Monitor prints in a formatted form the results of the 'wordCount' program
- * execution.
+ *  Monitor writes the results of the 'wordCount' program execution, file by
+ * file, in the format of the writer.
+ *
+ *  \param writer writer of the results.
  *
  */
-void printResults() {
+void printResults(struct resultWriter* writer) {
     // Enter monitor
     if ((statusMain = pthread_mutex_lock(&accessCR)) != 0) {
         errno = statusMain;
@@ -353,52 +623,9 @@ void printResults() {
     }
     pthread_once(&init, initialization);
 
-    // Print results from counts for all files
-    int i;
+    // Write results from counts for all files
     for (int k = 0; k < filesSize; k++) {
-        printf("File name: %s\n", filenames[k]);
-        printf("Total number of words: %d\n", numberWordsResults[k]);
-        printf("Word length\n");
-
-        printf("   ");
-        for (i = 1; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("%6d", i);
-        }
-        printf("\n   ");
-        for (i = 1; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("%6d", wordSizeResults[k][i]);
-        }
-        printf("\n   ");
-        for (i = 1; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("%6.2f", ((float)wordSizeResults[k][i] * 100.0) /
-                                (float)numberWordsResults[k]);
-        }
-        for (i = 0; i < maximumSizeWordResults[k] + 1; i++) {
-            printf("\n%2d ", i);
-            for (int j = 1; j < i; j++) {
-                printf("%6s", " ");
-            }
-            if (i == 0) {
-                for (int j = 1; j < maximumSizeWordResults[k] + 1; j++) {
-                    if (wordSizeResults[k][j] > 0) {
-                        printf("%6.1f", (vowelCountResults[k][i][j] * 100.0) /
-                                            (float)wordSizeResults[k][j]);
-                    } else {
-                        printf("%6.1f", 0.0);
-                    }
-                }
-            } else {
-                for (int j = i; j < maximumSizeWordResults[k] + 1; j++) {
-                    if (wordSizeResults[k][j] > 0) {
-                        printf("%6.1f", (vowelCountResults[k][i][j] * 100.0) /
-                                            (float)wordSizeResults[k][j]);
-                    } else {
-                        printf("%6.1f", 0.0);
-                    }
-                }
-            }
-        }
-        printf("\n\n");
+        writeFileResults(writer, &results, k, filenames[k]);
     }
 
     // Leave monitor
@@ -415,8 +642,11 @@ void printResults() {
  *
  *  Monitor frees memory allocated for its variables.
  *
+ *  \return EXIT_FAILURE if a file could not be read.
  */
-void destroy(void) {
+int destroy(void) {
+    int status = EXIT_SUCCESS;
+
     // Enter monitor
     if ((statusMain = pthread_mutex_lock(&accessCR)) != 0) {
         errno = statusMain;
@@ -426,21 +656,32 @@ void destroy(void) {
     }
     pthread_once(&init, initialization);
 
+    // Stop the reader thread
+    if (ringDepth > 0 && filesSize > 0) {
+        if (stopChunkRing(&chunkRing) != EXIT_SUCCESS) {
+            errno = EIO;
+            perror("Error while reading files in destroy.\n");
+            status = EXIT_FAILURE;
+        }
+        printChunkRingStats(&chunkRing);
+    }
+
     // Free allocated memory
-    free(files);
-    free(maximumSizeWordResults);
-    free(minimumSizeWordResults);
-    free(numberWordsResults);
-    for (int i = 0; i < filesSize; i++) {
-        for (int j = 0; j < MAXSIZE; j++) {
-            free(vowelCountResults[i][j]);
-            wordSizeResults[i][j] = 0;
+    for (int i = 0; i < filesSize && ringDepth == 0; i++) {
+        unmapInput(&inputs[i]);
+    }
+    for (int i = 0; i < numWorkers && deques != NULL; i++) {
+        destroyWorkDeque(&deques[i]);
+    }
+    for (int i = 0; i < numWorkers * filesSize; i++) {
+        if (workerHistograms[i] != NULL) {
+            freeHistogram(workerHistograms[i]);
         }
-        free(wordSizeResults[i]);
-        free(vowelCountResults[i]);
     }
-    free(wordSizeResults);
-    free(vowelCountResults);
+    pthread_barrier_destroy(&mergeStep);
+    freeResults(&results);
+    printArenaStats("Run", &runArena);
+    freeArena(&runArena);
     printf("Monitor destroyed.\n");
 
     // Leave monitor
@@ -450,4 +691,5 @@ void destroy(void) {
         statusMain = EXIT_FAILURE;
         pthread_exit(&statusMain);
     }
+    return status;
 }
@@ -18,6 +18,7 @@
 #define TEXTPROC_H
 
 #include "controlInfo.h"
+#include "../common/resultWriter.h"
 
 /** 
  *  \brief Retrieval of a portion of text (called text chunk).
@@ -25,22 +26,20 @@
  *  Monitor retrieves a portion of text (called text chunk) and assigns its processing for the worker that called the method.
  * 
  *  \param workerId internal worker thread identifier.
- *  \param textChunk portion of text to be processed by the worker.
- *  \param controlInfo structure containing control variables regarding the results of the worker.
+ *  \param controlInfo structure containing control variables regarding the results of the worker (receives the text chunk, its file and the worker's histogram of that file).
  * 
  */
-extern bool getTextChunk(int workerId, char* textChunk, struct controlInfo controlInfo);
+extern bool getTextChunk(int workerId, struct controlInfo* controlInfo);
 
 /** 
  *  \brief Update of global results.
  * 
- *  Monitor updates the global results with the results achieved by the worker that called the method.
+ *  Called once by every worker, after its last text chunk. The histograms of all workers are merged through a parallel tree reduction, and the worker left with the merged results updates the global results.
  * 
  *  \param workerId internal worker thread identifier.
- *  \param controlInfo structure containing control variables regarding the results of the worker.
  * 
  */
-extern void savePartialResults(int workerId, struct controlInfo controlInfo);
+extern void savePartialResults(int workerId);
 
 /** 
  *  \brief Presentation of all the files to be processed.
@@ -56,17 +55,20 @@ extern void presentFilenames(int size, char** filenames);
 /** 
  *  \brief Presentation of the global results achieved by all worker threads.
  * 
- *  Monitor prints in a formatted form the results of the 'wordCount' program execution.
+ *  Monitor writes the results of the 'wordCount' program execution, file by file, in the format of the writer.
+ * 
+ *  \param writer writer of the results.
  * 
  */
-extern void printResults();
+extern void printResults(struct resultWriter* writer);
 
 /** 
  *  \brief Destruction of monitor variables.
  * 
  *  Monitor frees memory allocated for its variables.
  * 
+ *  \return EXIT_FAILURE if a file could not be read.
  */
-extern void destroy();
+extern int destroy();
 
 #endif /* TEXTPROC_H */
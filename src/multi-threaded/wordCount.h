@@ -11,16 +11,7 @@
 #ifndef WORDCOUNT_H
 #define WORDCOUNT_H
 
-/** \brief number of worker threads. */
-#define NUMWORKERS 4
-
-/** \brief maximum size possible for a word. */
-#define MAXSIZE 50
-
 /** \brief maximum size (number of bytes) possible for a character. */
-#define MAXCHARSIZE 6
-
-/** \brief memory space (number of bytes) available for words under processing. */
-#define BUFFERSIZE 1000
+#define MAXCHARSIZE 8
 
 #endif /* WORDCOUNT_H */
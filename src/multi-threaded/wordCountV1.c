@@ -10,6 +10,7 @@
  */
 
 #include <dirent.h>
+#include <errno.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -26,32 +27,49 @@
 #include "chunk.h"
 #include "textProcV1.h"
 #include "wordCount.h"
+#include "workerStats.h"
+#include "../common/affinity.h"
+#include "../common/chunkPolicy.h"
+#include "../common/textScan.h"
+#include "../common/trace.h"
 
 #define BILLION 1000000000.0
 
 /** \brief worker life cycle routine. */
 static void *worker(void *id);
 
+/** \brief writing of the timeline of the workers. */
+static void writeWorkerTrace(void);
+
 /** \brief worker threads return status array. */
-int statusWorker[NUMWORKERS];
+int *statusWorker;
 
-/** \brief main thread return status value. */
-int statusMain;
+/** \brief number of worker threads. */
+int numWorkers;
+
+/** \brief largest size (number of bytes) of a text chunk. */
+size_t chunkSize = MAXCHUNKSIZE;
+
+/** \brief number of chunk buffers of the reading pipeline (0 if the files are mapped instead). */
+int ringDepth = 0;
+
+/** \brief largest number of files not fully claimed at the same time (0 for one per worker). */
+int maxFilesInFlight = 0;
+
+/** \brief whether the size and processing time of every text chunk are logged. */
+static bool logChunks = false;
+
+/** \brief whether the per-worker lock and phase counters are gathered and presented. */
+static bool gatherStats = false;
 
-/** \brief array containing all the characters defined as word delimiters. */
-char delimeters[25][MAXCHARSIZE] = {
-    " ", "-", "–", "—",  ".",  ",",  ":",  ";", "(", ")", "[", "]", "{",
-    "}", "?", "!", "\n", "\t", "\r", "\"", "“", "”", "«", "»", "…"};
+/** \brief writer of the results. */
+static struct resultWriter writer;
 
-/** \brief array containing all the characters defined as word mergers. */
-char mergers[7][MAXCHARSIZE] = {"‘", "’", "´", "`", "'", "ü", "Ü"};
+/** \brief path to the file the timeline of the workers is written to (NULL if not traced). */
+static const char *tracePath = NULL;
 
-/** \brief array containing all the possible vowels. */
-char vowels[48][MAXCHARSIZE] = {
-    "a", "e", "i", "o", "u", "A", "E", "I", "O", "U", "á", "à",
-    "ã", "â", "ä", "é", "è", "ẽ", "ê", "ë", "Á", "À", "Ã", "Â",
-    "Ä", "É", "È", "Ẽ", "Ê", "Ë", "ó", "ò", "õ", "ô", "ö", "Ó",
-    "Ò", "Õ", "Ô", "Ö", "í", "ì", "Í", "Ì", "ú", "ù", "Ú", "Ù"};
+/** \brief main thread return status value. */
+int statusMain;
 
 /** 
  *  \brief Main function called when the program is executed.
@@ -59,26 +77,95 @@ char vowels[48][MAXCHARSIZE] = {
  *  Main function of the 'wordCount' program responsible for creating worker threads and managing the monitor for delivering the desired results.
  *  The function receives the paths to the text files.
  * 
- *  \param argc number of files passed to the program.
- *  \param argv paths to the text files.
+ *  \param argc number of arguments passed to the program.
+ *  \param argv options followed by the paths to the text files: number of workers ('-j N' or '-j auto', one per physical core by default), largest chunk size ('-c SIZE', with an optional K, M or G suffix), number of files opened at the same time ('-f FILES', one per worker by default), reading through a pipeline of DEPTH chunk buffers filled by a reader thread ('-p DEPTH'), logging of every chunk to stderr ('-v'), presentation of the per-worker lock and phase counters ('-s'), format of the results ('-F text|json|csv|binary', text by default) path to the file they are written to ('-o FILE', the standard output by default) and path to the file a Chrome trace of the activity of the workers is written to ('-T FILE').
  * 
  */
 int main(int argc, char **argv) {
 
-    // Validate number of arguments passed to the program
+    // Declare useful variables
+
+    /** \brief number of workers requested (0 for one per physical core). */
+    int requested = 0;
+
+    /** \brief workers and CPUs they run on. */
+    struct workerPlan plan;
+
+    /** \brief format of the results. */
+    enum outputFormat format = OUTPUT_TEXT;
+
+    /** \brief path to the file the results are written to (NULL for the standard output). */
+    const char *outputPath = NULL;
+
+    /** \brief command line option under parsing. */
+    int opt;
 
-    if (argc <= 1) {
+    // Validate arguments passed to the program
+
+    while ((opt = getopt(argc, argv, "j:c:f:p:vsF:o:T:")) != -1) {
+        if ((opt == 'j' && !parseWorkerCount(optarg, &requested)) ||
+            (opt == 'c' && !parseChunkSize(optarg, &chunkSize)) ||
+            (opt == 'f' && (maxFilesInFlight = atoi(optarg)) <= 0) ||
+            (opt == 'p' && (ringDepth = atoi(optarg)) <= 0) ||
+            (opt == 'F' && !parseOutputFormat(optarg, &format)) || opt == '?') {
+            printf("Usage: %s [-j N|auto] [-c SIZE] [-f FILES] [-p DEPTH] [-v] "
+                   "[-s] [-F text|json|csv|binary] [-o FILE] "
+                   "[-T FILE] file...\n",
+                   argv[0]);
+            exit(1);
+        }
+        if (opt == 'v') {
+            logChunks = true;
+        }
+        if (opt == 's') {
+            gatherStats = true;
+        }
+        if (opt == 'o') {
+            outputPath = optarg;
+        }
+        if (opt == 'T') {
+            tracePath = optarg;
+        }
+    }
+    if (optind >= argc) {
         printf("The program need at least one text file to parse!\n");
         exit(1);
     }
-
-    // Declare useful variables
+    if (format != OUTPUT_TEXT && outputPath == NULL) {
+        printf("The json, csv and binary formats need an output file (-o FILE)!\n");
+        exit(1);
+    }
+    initTextScan();
+    if (!openResultWriter(&writer, outputPath, format)) {
+        printf("Error while opening file!\n");
+        exit(1);
+    }
+    if (!planWorkers(requested, &plan)) {
+        perror("Error while allocating memory in main.\n");
+        exit(EXIT_FAILURE);
+    }
+    numWorkers = plan.numWorkers;
+    if (maxFilesInFlight == 0) {
+        maxFilesInFlight = numWorkers;
+    }
+    if ((gatherStats && !initWorkerStats(numWorkers)) ||
+        (tracePath != NULL && !initTrace(numWorkers))) {
+        perror("Error while allocating memory in main.\n");
+        exit(EXIT_FAILURE);
+    }
+    printWorkerPlan(&plan);
 
     /** \brief workers internal thread id array. */
-    pthread_t workerThreadID[NUMWORKERS];
+    pthread_t *workerThreadID = malloc(sizeof(pthread_t) * numWorkers);
 
     /** \brief workers application defined thread id array. */
-    unsigned int workerID[NUMWORKERS];
+    unsigned int *workerID = malloc(sizeof(unsigned int) * numWorkers);
+
+    statusWorker = malloc(sizeof(int) * numWorkers);
+    if (workerThreadID == NULL || workerID == NULL || statusWorker == NULL) {
+        perror("Error while allocating memory in main.\n");
+        exit(EXIT_FAILURE);
+    }
 
     /** \brief pointer to execution status. */
     int *status_p;
@@ -91,7 +178,7 @@ int main(int argc, char **argv) {
 
     // Initialization of thread IDs
 
-    for (i = 0; i < NUMWORKERS; i++) {
+    for (i = 0; i < numWorkers; i++) {
         workerID[i] = i;
     }
     srandom((unsigned int)getpid());
@@ -100,25 +187,28 @@ int main(int argc, char **argv) {
 
     // Retrieval of filenames
 
-    char *files[argc - 1];
-    for (i = 1; i < argc; i++) {
-        files[i - 1] = argv[i];
+    char *files[argc - optind];
+    for (i = optind; i < argc; i++) {
+        files[i - optind] = argv[i];
     }
-    presentFilenames(argc - 1, files);
+    presentFilenames(argc - optind, files);
 
     // Generation of worker threads
 
-    for (i = 0; i < NUMWORKERS; i++) {
+    for (i = 0; i < numWorkers; i++) {
         if (pthread_create(&workerThreadID[i], NULL, worker, &workerID[i]) != 0) {
             perror("Error on creating thread worker.\n");
             exit(EXIT_FAILURE);
         }
+        if ((errno = pinWorker(&plan, workerThreadID[i], i)) != 0) {
+            perror("Error on pinning thread worker.\n");
+        }
     }
     printf("Threads created.\n");
 
     // Report post task completion (by workers)
 
-    for (i = 0; i < NUMWORKERS; i++) {
+    for (i = 0; i < numWorkers; i++) {
         if (pthread_join(workerThreadID[i], (void *)&status_p) != 0) {
             perror("Error on waiting for thread worker.\n");
             exit(EXIT_FAILURE);
@@ -126,8 +216,20 @@ int main(int argc, char **argv) {
         printf("thread worker, with id %u, has terminated: ", i);
         printf("its status was %d\n", *status_p);
     }
-    printResults();
-    destroy();
+    printResults(&writer);
+    if (!closeResultWriter(&writer)) {
+        perror("Error while writing the results.\n");
+        exit(EXIT_FAILURE);
+    }
+    printWorkerStats();
+    if (tracePath != NULL) {
+        writeWorkerTrace();
+    }
+    int status = destroy();
+    free(workerThreadID);
+    free(workerID);
+    free(statusWorker);
+    freeWorkerPlan(&plan);
 
     // Execution time calculation
 
@@ -138,7 +240,23 @@ int main(int argc, char **argv) {
     double exec_time = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / BILLION;
     printf("\nElapsed time = %.6f s\n", exec_time);
 
-    exit(EXIT_SUCCESS);
+    exit(status);
+}
+
+/**
+ *  \brief Writing of the timeline of the workers to the trace file.
+ *
+ */
+static void writeWorkerTrace(void) {
+    char *events;
+    size_t len;
+
+    if ((events = formatTrace(0, "wordCount", &len)) == NULL ||
+        !writeTrace(tracePath, events, len)) {
+        perror("Error while writing the trace.\n");
+    }
+    free(events);
+    freeTrace();
 }
 
 /**
@@ -161,202 +279,81 @@ static void *worker(void *par) {
 
     // char stringBuffer[MAXSIZE];             // buffer containing the current word
 
-    /** \brief number of characters in current word. */
-    int stringSize;
-
-    /** \brief number of vowels in current word. */
-    int numVowels;
-
-    /** \brief current char under processing from the current chunk. */
-    char symbol;
-
-    /** \brief buffer for complex character construction. */
-    char completeSymbol[MAXCHARSIZE]; 
+    /** \brief state of the word under construction. */
+    struct wordScanner scanner;
 
-    /** \brief array containing the number of words found whose size is equal to the respective index. */
-    int wordCount[MAXSIZE];
-    
-    // int vowelsCount[MAXSIZE][MAXSIZE];      // 2D array containing the number of words found whose number of vowels and word size are equal to x and y
+    /** \brief occurrence frequencies found by the worker in the file of the current text chunk. */
+    struct histogram *hist;
 
-    /** \brief 2D array containing the number of words found whose number of vowels and word size are equal to x and y. */
-    int **vowelsCount;
+    /** \brief processing time limits of the current text chunk (when logged). */
+    struct timespec c0, c1;
 
-    /** \brief largest word found in the text chunk. */
-    int localMaxWordSize;
+    /** \brief time the current phase started (when counters are gathered). */
+    double mark = 0;
 
-    /** \brief largest number of vowels found in a word from the text chunk. */
-    int localMaxVocalCount;
-
-    /** \brief auxiliar variable to count the number of ones in the most significant bits of the current character. */
-    int ones;
-
-    /** \brief auxiliar variable to construct the complete symbol (used for those who use more than 1 byte). */
-    char nchar;
-
-    /** \brief auxiliar variable to determine whether the program should update 'numVowels' and 'stringSize' or not. */
-    int control;
-
-    /** \brief auxiliar variable to determine whether the program should update 'stringSize' and 'stringBuffer' or not. */
-    bool increment;
-
-    /** \brief auxiliar variables for local loops. */
-    int h, i, j;
+    /** \brief time the current span started (when traced). */
+    double traced;
 
     // Initialize thread variables
 
     id = *((int *)par);
-    chunk = getTextChunk(id);
-    for (i = 0; i < MAXSIZE; i++) {
-        wordCount[i] = 0;
+    bindWorkerStats(id);
+    if (ownStats != NULL) {
+        mark = statsClock();
     }
-    // vowelsCount = malloc(sizeof(int *) * (MAXSIZE));
-    if ((vowelsCount = malloc(sizeof(int *) * (MAXSIZE))) == NULL) {
-        perror("Error while allocating memory for worker thread.\n");
-        statusWorker[id] = EXIT_FAILURE;
-        pthread_exit(&statusWorker[id]);
-    }
-    for (i = 0; i < MAXSIZE; i++) {
-        // vowelsCount[i] = malloc(sizeof(int) * (MAXSIZE));
-        if ((vowelsCount[i] = malloc(sizeof(int) * (MAXSIZE))) == NULL) {
-            perror("Error while allocating memory for worker thread.\n");
-            statusWorker[id] = EXIT_FAILURE;
-            pthread_exit(&statusWorker[id]);
-        }
-        for (j = 0; j < MAXSIZE; j++) {
-            vowelsCount[i][j] = 0;
-        }
-    }
-    localMaxWordSize = 0;
-    localMaxVocalCount = 0;
-    numVowels = 0;
-    stringSize = 0;
+    bindTraceThread(id, "worker");
+    traced = traceMark();
+    chunk = getTextChunk(id);
+    initScanner(&scanner);
     // strcpy(stringBuffer, "");
-    control = 0;
 
     // Process text chunk
 
-    while (strcmp(chunk.textChunk, "") != 0) {
-        for (h = 0; h < strlen(chunk.textChunk); h++) {
-            symbol = chunk.textChunk[h];
-            strcpy(completeSymbol, "");
-            increment = true;
-            ones = 0;
-
-            // Verify the number of 1s in the most significant bits
-
-            for (i = sizeof(symbol) * CHAR_BIT - 1; i >= 0; --i) {
-                int bit = (symbol >> i) & 1;
-                if (bit == 0) {
-                    break;
-                }
-                ones++;
-            }
-
-            // Build the complete character (if it consists of more than 1 byte)
-
-            strncat(completeSymbol, &symbol, 1);
-            for (i = 1; i < ones; i++) {
-                h++;
-                nchar = chunk.textChunk[h];
-                strncat(completeSymbol, &nchar, 1);
-            }
-
-            // Check if character is a delimiter
-
-            for (i = 0; i < sizeof(delimeters) / sizeof(delimeters[0]); i++) {
-                if (strcmp(completeSymbol, delimeters[i]) == 0) {
-                    control = 1;
-                    if (stringSize > 0) {
-                        wordCount[stringSize]++;
-                        vowelsCount[numVowels][stringSize]++;
-                        // totalNumberOfWords++;
-                        // strcpy(stringBuffer, "");
-                        numVowels = 0;
-                        stringSize = 0;
-                    }
-                    break;
-                }
-            }
-
-            // Skip remaining steps if current character is a delimiter
-
-            if (control == 1) {
-                control = 0;
-                continue;
-            }
-
-            // Increment word size and add character to current word (if applicable)
-
-            for (i = 0; i < sizeof(mergers) / sizeof(mergers[0]); i++) {
-                if (strcmp(completeSymbol, mergers[i]) == 0) {
-                    increment = false;
-                    break;
-                }
-            }
-            if (increment) {
-                stringSize++;
-                if (stringSize > localMaxWordSize) {
-                    localMaxWordSize = stringSize;
-                }
-                // strcat(stringBuffer, completeSymbol);
-            }
-
-            // Increment number of vowels (if applicable)
-
-            for (i = 0; i < sizeof(vowels) / sizeof(vowels[0]); i++) {
-                if (strcmp(completeSymbol, vowels[i]) == 0) {
-                    numVowels++;
-                    if (numVowels > localMaxVocalCount) {
-                        localMaxVocalCount = numVowels;
-                    }
-                    break;
-                }
-            }
+    while (chunk.textSize > 0) {
+        if (ownStats != NULL) {
+            statsLap(&ownStats->claimTime, &mark);
         }
-        // Consider last word of file
-
-        if (stringSize > 0) {
-            wordCount[stringSize]++;
-            vowelsCount[numVowels][stringSize]++;
-            if (stringSize > localMaxWordSize) {
-                localMaxWordSize = stringSize;
-            }
-            // totalNumberOfWords++;
-            // strcpy(stringBuffer, "");
-            numVowels = 0;
-            stringSize = 0;
+        traceLap("fetch", &traced);
+        if (logChunks) {
+            clock_gettime(CLOCK_MONOTONIC, &c0);
         }
+        hist = getPartialResults(id, chunk.fileId);
+        scanText(&scanner, chunk.textChunk, chunk.textSize, true, hist);
 
-        // Save chunk processing results
+        // Consider last word of file
 
-        savePartialResults(id, chunk.fileId, wordCount, localMaxWordSize + 1,
-                           vowelsCount, localMaxVocalCount + 1,
-                           localMaxWordSize + 1);
+        endWord(&scanner, hist);
 
-        // Reset thread variables
+        // Log chunk size and processing time
 
-        for (i = 0; i < MAXSIZE; i++) {
-            wordCount[i] = 0;
+        if (logChunks) {
+            clock_gettime(CLOCK_MONOTONIC, &c1);
+            fprintf(stderr, "Chunk: worker %d, file %d, %zu bytes, %.6f s\n", id, chunk.fileId, chunk.textSize,
+                    (c1.tv_sec - c0.tv_sec) + (c1.tv_nsec - c0.tv_nsec) / BILLION);
         }
-        for (i = 0; i < MAXSIZE; i++) {
-            for (j = 0; j < MAXSIZE; j++) {
-                vowelsCount[i][j] = 0;
-            }
+        if (ownStats != NULL) {
+            statsLap(&ownStats->scanTime, &mark);
+            ownStats->chunks++;
+            ownStats->bytes += chunk.textSize;
         }
-        localMaxWordSize = 0;
-        localMaxVocalCount = 0;
+        traceLap("scan", &traced);
 
         // Retrieve next chunk
 
         chunk = getTextChunk(id);
     }
 
-    // Free used memory
+    // Save processing results
 
-    for (i = 0; i < MAXSIZE; i++) {
-        free(vowelsCount[i]);
+    if (ownStats != NULL) {
+        statsLap(&ownStats->claimTime, &mark);
+    }
+    traceLap("fetch", &traced);
+    savePartialResults(id);
+    if (ownStats != NULL) {
+        statsLap(&ownStats->mergeTime, &mark);
     }
-    free(vowelsCount);
+    traceLap("merge", &traced);
 
     statusWorker[id] = EXIT_SUCCESS;
     pthread_exit(&statusWorker[id]);
@@ -0,0 +1,101 @@
+/**
+ *  \file workDeque.c (implementation file)
+ *
+ *  \brief Work-stealing deques of text ranges.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "workDeque.h"
+#include "workerStats.h"
+
+bool initWorkDeque(struct workDeque* deque, size_t capacity,
+                   struct arena* arena) {
+    if ((deque->ranges = arenaAlloc(arena, sizeof(struct textRange) *
+                                               capacity)) == NULL) {
+        return false;
+    }
+    deque->capacity = capacity;
+    deque->top = 0;
+    deque->bottom = 0;
+    return pthread_mutex_init(&deque->lock, NULL) == 0;
+}
+
+void destroyWorkDeque(struct workDeque* deque) {
+    pthread_mutex_destroy(&deque->lock);
+}
+
+bool pushRange(struct workDeque* deque, struct textRange range) {
+    bool pushed = false;
+
+    lockCounted(&deque->lock);
+    // Move the ranges held back to the start of the array once its end is
+    // reached, so that only the ranges held count against the capacity
+    if (deque->bottom == deque->capacity && deque->top > 0) {
+        memmove(deque->ranges, deque->ranges + deque->top,
+                sizeof(struct textRange) * (deque->bottom - deque->top));
+        deque->bottom -= deque->top;
+        deque->top = 0;
+    }
+    if (deque->bottom < deque->capacity) {
+        deque->ranges[deque->bottom++] = range;
+        pushed = true;
+    }
+    unlockCounted(&deque->lock);
+    return pushed;
+}
+
+bool popRange(struct workDeque* deque, struct textRange* range) {
+    bool popped = false;
+
+    lockCounted(&deque->lock);
+    if (deque->top < deque->bottom) {
+        *range = deque->ranges[--deque->bottom];
+        popped = true;
+    }
+    unlockCounted(&deque->lock);
+    return popped;
+}
+
+/**
+ *  \brief Removal of the range at the top of a deque.
+ *
+ *  \param deque deque to update.
+ *  \param range range removed.
+ *
+ *  \return false if the deque is empty.
+ */
+static bool takeOldestRange(struct workDeque* deque, struct textRange* range) {
+    bool taken = false;
+
+    lockCounted(&deque->lock);
+    if (deque->top < deque->bottom) {
+        *range = deque->ranges[deque->top++];
+        taken = true;
+    }
+    unlockCounted(&deque->lock);
+    return taken;
+}
+
+bool stealRange(struct workDeque* deques, int numDeques, int thief,
+                unsigned int* seed, struct textRange* range) {
+    if (numDeques < 2) {
+        return false;
+    }
+
+    // Try every other worker, starting from a random one
+    int first = rand_r(seed) % (numDeques - 1);
+    for (int i = 0; i < numDeques - 1; i++) {
+        int victim = (first + i) % (numDeques - 1);
+        if (victim >= thief) {
+            victim++;
+        }
+        if (takeOldestRange(&deques[victim], range)) {
+            return true;
+        }
+    }
+    return false;
+}
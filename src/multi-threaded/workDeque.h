@@ -0,0 +1,115 @@
+/**
+ *  \file workDeque.h (interface file)
+ *
+ *  \brief Work-stealing deques of text ranges.
+ *
+ *  Every worker owns a deque of byte ranges of the files presented. The owner
+ * takes ranges from the bottom of its deque and puts back what it does not
+ * process right away; a worker whose deque is empty steals the range at the
+ * top of the deque of another worker, chosen at random. Each deque has its own
+ * lock, only ever contended by a thief.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef WORKDEQUE_H
+#define WORKDEQUE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../common/arena.h"
+#include "../common/histogram.h"
+
+/**
+ *  \brief structure containing a range of bytes of a file.
+ */
+struct textRange {
+    /** \brief identifier of the file the range belongs to. */
+    int fileId;
+
+    /** \brief offset of the first byte of the range. */
+    size_t start;
+
+    /** \brief offset following the last byte of the range. */
+    size_t end;
+};
+
+/**
+ *  \brief structure containing the deque of ranges of a worker.
+ */
+struct workDeque {
+    /** \brief lock protecting the deque. */
+    pthread_mutex_t lock;
+
+    /** \brief ranges held, from 'top' (oldest) to 'bottom' (newest). */
+    struct textRange* ranges;
+
+    /** \brief number of entries of 'ranges'. */
+    size_t capacity;
+
+    /** \brief position of the oldest range. */
+    size_t top;
+
+    /** \brief position following the newest range. */
+    size_t bottom;
+} __attribute__((aligned(CACHELINESIZE)));
+
+/**
+ *  \brief Initialization of an empty deque.
+ *
+ *  \param deque deque to initialize.
+ *  \param capacity largest number of ranges held at once.
+ *  \param arena arena the ranges are allocated from.
+ *
+ *  \return false if memory could not be allocated.
+ */
+extern bool initWorkDeque(struct workDeque* deque, size_t capacity,
+                          struct arena* arena);
+
+/**
+ *  \brief Destruction of a deque (its memory belongs to the arena).
+ *
+ *  \param deque deque to destroy.
+ *
+ */
+extern void destroyWorkDeque(struct workDeque* deque);
+
+/**
+ *  \brief Insertion of a range at the bottom of a deque (by its owner).
+ *
+ *  \param deque deque to update.
+ *  \param range range to insert.
+ *
+ *  \return false if the deque holds 'capacity' ranges already.
+ */
+extern bool pushRange(struct workDeque* deque, struct textRange range);
+
+/**
+ *  \brief Removal of the range at the bottom of a deque (by its owner).
+ *
+ *  \param deque deque to update.
+ *  \param range range removed.
+ *
+ *  \return false if the deque is empty.
+ */
+extern bool popRange(struct workDeque* deque, struct textRange* range);
+
+/**
+ *  \brief Removal of the range at the top of the deque of another worker.
+ *
+ *  Victims are tried in turn, starting from one chosen at random.
+ *
+ *  \param deques deques of all workers.
+ *  \param numDeques number of workers.
+ *  \param thief identifier of the worker stealing.
+ *  \param seed state of the thief's random number generator.
+ *  \param range range removed.
+ *
+ *  \return false if all the other deques are empty.
+ */
+extern bool stealRange(struct workDeque* deques, int numDeques, int thief,
+                       unsigned int* seed, struct textRange* range);
+
+#endif /* WORKDEQUE_H */
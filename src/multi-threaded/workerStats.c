@@ -0,0 +1,81 @@
+/**
+ *  \file workerStats.c (implementation file)
+ *
+ *  \brief Per-worker counters of the time spent on locks and in every phase of
+ * the worker loop.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "workerStats.h"
+
+_Thread_local struct workerStats* ownStats = NULL;
+
+/** \brief entries of all workers (NULL if disabled). */
+static struct workerStats* allStats = NULL;
+
+/** \brief number of entries of 'allStats'. */
+static int numStats = 0;
+
+bool initWorkerStats(int numWorkers) {
+    size_t size = sizeof(struct workerStats) * numWorkers;
+
+    if ((allStats = aligned_alloc(CACHELINESIZE, size)) == NULL) {
+        return false;
+    }
+    memset(allStats, 0, size);
+    numStats = numWorkers;
+    return true;
+}
+
+void bindWorkerStats(int workerId) {
+    if (allStats != NULL) {
+        ownStats = &allStats[workerId];
+    }
+}
+
+/**
+ *  \brief Presentation of a line of the table of counters.
+ *
+ *  \param name name of the line.
+ *  \param stats counters.
+ *
+ */
+static void printStatsLine(const char* name, const struct workerStats* stats) {
+    printf("%-7s %8ld %12lld %10.6f %10.6f %10.6f %9ld %10.6f %10.6f\n", name,
+           stats->chunks, stats->bytes, stats->claimTime, stats->scanTime,
+           stats->mergeTime, stats->lockAcquisitions, stats->lockWait,
+           stats->lockHold);
+}
+
+void printWorkerStats(void) {
+    struct workerStats total;
+    char name[16];
+
+    if (allStats == NULL) {
+        return;
+    }
+    memset(&total, 0, sizeof(total));
+    printf("\n%-7s %8s %12s %10s %10s %10s %9s %10s %10s\n", "Worker",
+           "Chunks", "Bytes", "Claim (s)", "Scan (s)", "Merge (s)", "Locks",
+           "Wait (s)", "Hold (s)");
+    for (int i = 0; i < numStats; i++) {
+        snprintf(name, sizeof(name), "%d", i);
+        printStatsLine(name, &allStats[i]);
+        total.chunks += allStats[i].chunks;
+        total.bytes += allStats[i].bytes;
+        total.claimTime += allStats[i].claimTime;
+        total.scanTime += allStats[i].scanTime;
+        total.mergeTime += allStats[i].mergeTime;
+        total.lockAcquisitions += allStats[i].lockAcquisitions;
+        total.lockWait += allStats[i].lockWait;
+        total.lockHold += allStats[i].lockHold;
+    }
+    printStatsLine("Total", &total);
+    free(allStats);
+    allStats = NULL;
+}
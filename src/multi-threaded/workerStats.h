@@ -0,0 +1,148 @@
+/**
+ *  \file workerStats.h (interface file)
+ *
+ *  \brief Per-worker counters of the time spent on locks and in every phase of
+ * the worker loop.
+ *
+ *  When enabled, every worker owns a cache-line aligned entry counting the
+ * locks it takes (the monitor's and the work deques'), the time it waits for
+ * them and holds them, the text chunks and bytes it scans, and the time it
+ * spends claiming chunks, scanning them and merging its results. All times are
+ * read from the monotonic clock. When disabled, a worker has no entry and the
+ * only cost left is a test of a null thread-local pointer.
+ *
+ *  \author Filipe Pires (85122) and João Alegria (85048) - October 2026
+ */
+
+#ifndef WORKERSTATS_H
+#define WORKERSTATS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "../common/histogram.h"
+
+/**
+ *  \brief structure containing the counters of a worker.
+ */
+struct workerStats {
+    /** \brief number of locks taken. */
+    long lockAcquisitions;
+
+    /** \brief time (seconds) spent waiting for locks. */
+    double lockWait;
+
+    /** \brief time (seconds) spent holding locks. */
+    double lockHold;
+
+    /** \brief time the lock held was taken. */
+    double lockedAt;
+
+    /** \brief number of text chunks scanned. */
+    long chunks;
+
+    /** \brief number of bytes scanned. */
+    long long bytes;
+
+    /** \brief time (seconds) spent claiming text chunks. */
+    double claimTime;
+
+    /** \brief time (seconds) spent scanning text chunks. */
+    double scanTime;
+
+    /** \brief time (seconds) spent merging results. */
+    double mergeTime;
+} __attribute__((aligned(CACHELINESIZE)));
+
+/** \brief entry of the calling worker (NULL if disabled or not a worker). */
+extern _Thread_local struct workerStats* ownStats;
+
+/**
+ *  \brief Current time of the monotonic clock.
+ *
+ *  \return time (seconds).
+ */
+static inline double statsClock(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ *  \brief Charge of the time elapsed since a mark to a phase.
+ *
+ *  \param phase time (seconds) of the phase to update.
+ *  \param mark time the phase started, moved to the current time.
+ *
+ */
+static inline void statsLap(double* phase, double* mark) {
+    double now = statsClock();
+
+    *phase += now - *mark;
+    *mark = now;
+}
+
+/**
+ *  \brief Lock of a mutex, counted for the calling worker.
+ *
+ *  \param lock mutex.
+ *
+ *  \return status of 'pthread_mutex_lock'.
+ */
+static inline int lockCounted(pthread_mutex_t* lock) {
+    if (ownStats == NULL) {
+        return pthread_mutex_lock(lock);
+    }
+    double start = statsClock();
+    int status = pthread_mutex_lock(lock);
+    ownStats->lockedAt = statsClock();
+    ownStats->lockWait += ownStats->lockedAt - start;
+    ownStats->lockAcquisitions++;
+    return status;
+}
+
+/**
+ *  \brief Unlock of a mutex taken by 'lockCounted'.
+ *
+ *  \param lock mutex.
+ *
+ *  \return status of 'pthread_mutex_unlock'.
+ */
+static inline int unlockCounted(pthread_mutex_t* lock) {
+    if (ownStats != NULL) {
+        ownStats->lockHold += statsClock() - ownStats->lockedAt;
+    }
+    return pthread_mutex_unlock(lock);
+}
+
+/**
+ *  \brief Allocation of the (zeroed) entries of all workers.
+ *
+ *  \param numWorkers number of workers.
+ *
+ *  \return false if memory could not be allocated.
+ */
+extern bool initWorkerStats(int numWorkers);
+
+/**
+ *  \brief Binding of the calling thread to the entry of a worker.
+ *
+ *  Does nothing unless the entries were allocated.
+ *
+ *  \param workerId internal worker thread identifier.
+ *
+ */
+extern void bindWorkerStats(int workerId);
+
+/**
+ *  \brief Presentation of the counters of all workers, and their totals.
+ *
+ *  Does nothing unless the entries were allocated; they are released
+ * afterwards.
+ *
+ */
+extern void printWorkerStats(void);
+
+#endif /* WORKERSTATS_H */
@@ -18,14 +18,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
-#define BILLION 1000000000.0
+#include "../common/resultWriter.h"
+#include "../common/textScan.h"
 
-/** \brief maximum size possible for a word. */
-#define MAXSIZE 50
+#define BILLION 1000000000.0
 
-/** \brief maximum size (number of bytes) possible for a character. */
-#define MAXCHARSIZE 6
+/** \brief memory space (number of bytes) read from a file at once. */
+#define READSIZE 65536
 
 /**
  *  \brief Main function called when the program is executed.
@@ -33,71 +34,83 @@
  *  Main function of the 'wordCount' program containing all of its logic.
  *  The function receives the paths to the text files.
  *
- *  \param argc number of files passed to the program.
- *  \param argv paths to the text files.
+ *  \param argc number of arguments passed to the program.
+ *  \param argv options followed by the paths to the text files: format of the
+ * results ('-F text|json|csv|binary', text by default) and path to the file
+ * they are written to ('-o FILE', the standard output by default).
  *
  */
 int main(int argc, char **argv) {
     // Declare useful variables
 
-    /** \brief array containing all the characters defined as word delimiters.
-     */
-    char delimeters[25][MAXCHARSIZE] = {
-        " ", "-", "–", "—",  ".",  ",",  ":",  ";", "(", ")", "[", "]", "{",
-        "}", "?", "!", "\n", "\t", "\r", "\"", "“", "”", "«", "»", "…"};
-
-    /** \brief array containing all the characters defined as word mergers. */
-    char mergers[7][MAXCHARSIZE] = {"‘", "’", "´", "`", "'", "ü", "Ü"};
-
-    /** \brief array containing all the the possible vowels. */
-    char vowels[48][MAXCHARSIZE] = {
-        "a", "e", "i", "o", "u", "A", "E", "I", "O", "U", "á", "à",
-        "ã", "â", "ä", "é", "è", "ẽ", "ê", "ë", "Á", "À", "Ã", "Â",
-        "Ä", "É", "È", "Ẽ", "Ê", "Ë", "ó", "ò", "õ", "ô", "ö", "Ó",
-        "Ò", "Õ", "Ô", "Ö", "í", "ì", "Í", "Ì", "ú", "ù", "Ú", "Ù"};
-
     /** \brief pointer to the file currently under processing. */
     FILE *file;
 
-    /** \brief number of vowels in current word. */
-    int numVowels;
+    /** \brief state of the word under construction. */
+    struct wordScanner scanner;
 
-    /** \brief number of characters in current word. */
-    int stringSize;
+    /** \brief buffer containing the text read from the current file. */
+    static char textBuffer[READSIZE];
 
-    /** \brief buffer containing the current word. */
-    char stringBuffer[MAXSIZE] = "";
+    /** \brief number of bytes stored in 'textBuffer'. */
+    size_t textSize;
 
-    /** \brief auxiliar variables for local loops. */
-    int i, j;
+    /** \brief number of bytes of 'textBuffer' already processed. */
+    size_t consumed;
 
-    /** \brief auxiliar variable to count the number of ones in the most
-     * significant bits of the current character. */
-    int ones;
+    /** \brief final results of every file. */
+    struct results results;
 
-    /** \brief auxiliar variable to construct the complete symbol (used for
-     * those who use more than 1 byte). */
-    char nchar;
+    /** \brief format of the results. */
+    enum outputFormat format = OUTPUT_TEXT;
 
-    /** \brief auxiliar variable to determine whether the program should update
-     * 'numVowels' and 'stringSize' or not. */
-    int control;
+    /** \brief path to the file the results are written to (NULL for the
+     * standard output). */
+    const char *outputPath = NULL;
 
-    /** \brief auxiliar variable to determine whether the program should update
-     * 'stringSize' and 'stringBuffer' or not. */
-    bool increment;
+    /** \brief writer of the results. */
+    static struct resultWriter writer;
+
+    /** \brief command line option under parsing. */
+    int opt;
 
     // Validate program arguments
 
-    if (argc <= 1) {
+    while ((opt = getopt(argc, argv, "F:o:")) != -1) {
+        if (opt == 'F' && !parseOutputFormat(optarg, &format)) {
+            opt = '?';
+        }
+        if (opt == 'o') {
+            outputPath = optarg;
+        }
+        if (opt == '?') {
+            printf("Usage: %s [-F text|json|csv|binary] [-o FILE] file...\n",
+                   argv[0]);
+            exit(1);
+        }
+    }
+    if (optind >= argc) {
         printf("The program need at least one text file to parse!\n");
         exit(1);
     }
+    if (format != OUTPUT_TEXT && outputPath == NULL) {
+        printf("The json, csv and binary formats need an output file (-o FILE)!\n");
+        exit(1);
+    }
+    initTextScan();
+    if (!allocResults(&results, argc - optind, HISTSIZE)) {
+        perror("Error while allocating memory.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (!openResultWriter(&writer, outputPath, format)) {
+        printf("Error while opening file!\n");
+        exit(1);
+    }
 
     // Process all files passed as arguments and compute the occurring frequency
     // of word lengths and the number of vowels in each word
 
-    for (int fileIndex = 1; fileIndex < argc; fileIndex++) {
+    for (int fileIndex = optind; fileIndex < argc; fileIndex++) {
         file = fopen(argv[fileIndex], "r");
         if (file == NULL) {
             // end of file error
@@ -106,169 +119,40 @@ int main(int argc, char **argv) {
         } else {
             // Declare and initialize variables dedicated to the current file
 
-            /** \brief size of the largest word found. */
-            int largestWordSize = 0;
-
-            /** \brief total number of words of the current file. */
-            int totalNumberOfWords = 0;
-
-            /** \brief current character being processed. */
-            char symbol;
-
-            /** \brief buffer for complex character construction. */
-            char completeSymbol[MAXCHARSIZE];
-
-            /** \brief array containing the number of words found whose size is
-             * equal to the respective index. */
-            int wordCount[MAXSIZE];
-
-            /** \brief 2D array containing the number of words found whose
-             * number of vowels and word size are equal to x and y. */
-            int vowelsCount[MAXSIZE][MAXSIZE];
-
-            for (i = 0; i < MAXSIZE; i++) {
-                wordCount[i] = 0;
-                for (j = 0; j < MAXSIZE; j++) {
-                    vowelsCount[i][j] = 0;
-                }
-            }
-            numVowels = 0;
-            stringSize = 0;
-            strcpy(stringBuffer, "");
-            control = 0;
-
-            while ((symbol = getc(file)) != EOF) {
-                strcpy(completeSymbol, "");
-                increment = true;
-                ones = 0;
-
-                // Verify the number of 1s in the most significant bits
-                for (i = sizeof(symbol) * CHAR_BIT - 1; i >= 0; --i) {
-                    int bit = (symbol >> i) & 1;
-                    if (bit == 0) {
-                        break;
-                    }
-                    ones++;
-                }
-
-                // Build the complete character (if it consists of more than 1
-                // byte)
-                strncat(completeSymbol, &symbol, 1);
-                for (i = 1; i < ones; i++) {
-                    nchar = getc(file);
-                    strncat(completeSymbol, &nchar, 1);
-                }
-
-                // Check if character is a delimiter
-                for (i = 0; i < sizeof(delimeters) / sizeof(delimeters[0]);
-                     i++) {
-                    if (strcmp(completeSymbol, delimeters[i]) == 0) {
-                        control = 1;
-                        if (strlen(stringBuffer) > 0) {
-                            wordCount[stringSize]++;
-                            vowelsCount[numVowels][stringSize]++;
-                            if (stringSize > largestWordSize) {
-                                largestWordSize = stringSize;
-                            }
-                            totalNumberOfWords++;
-                            strcpy(stringBuffer, "");
-                            numVowels = 0;
-                            stringSize = 0;
-                        }
-                        break;
-                    }
-                }
-
-                // Skip remaining steps if current character is a delimiter
-                if (control == 1) {
-                    control = 0;
-                    continue;
-                }
-
-                // Increment word size and add character to current word (if
-                // applicable)
-                for (i = 0; i < sizeof(mergers) / sizeof(mergers[0]); i++) {
-                    if (strcmp(completeSymbol, mergers[i]) == 0) {
-                        increment = false;
-                        break;
-                    }
-                }
-                if (increment) {
-                    stringSize++;
-                    strcat(stringBuffer, completeSymbol);
-                }
-
-                // Increment number of vowels (if applicable)
-                for (i = 0; i < sizeof(vowels) / sizeof(vowels[0]); i++) {
-                    if (strcmp(completeSymbol, vowels[i]) == 0) {
-                        numVowels++;
-                        break;
-                    }
-                }
+            /** \brief occurrence frequencies of the current file. */
+            static struct histogram hist;
+
+            initHistogram(&hist);
+            initScanner(&scanner);
+
+            // Process the file one buffer at a time (a character cut short by
+            // the end of the buffer is carried to the next one)
+            textSize = 0;
+            while ((consumed = fread(textBuffer + textSize, 1,
+                                     READSIZE - textSize, file)) > 0) {
+                textSize += consumed;
+                consumed = scanText(&scanner, textBuffer, textSize, false, &hist);
+                memmove(textBuffer, textBuffer + consumed, textSize - consumed);
+                textSize -= consumed;
             }
+            scanText(&scanner, textBuffer, textSize, true, &hist);
 
             // Consider last word of file
-            if (strlen(stringBuffer) > 0) {
-                control = 1;
-                wordCount[stringSize]++;
-                // vowelsCount[stringSize][numVowels] += numVowels;
-                vowelsCount[numVowels][stringSize]++;
-                if (stringSize > largestWordSize) {
-                    largestWordSize = stringSize;
-                }
-                totalNumberOfWords++;
-                strcpy(stringBuffer, "");
-                numVowels = 0;
-                stringSize = 0;
-            }
+            endWord(&scanner, &hist);
 
-            // Print information table
-            printf("File name: %s\n", argv[fileIndex]);
-            printf("Total number of words: %d\n", totalNumberOfWords);
-            printf("Word length\n");
-
-            printf("   ");
-            for (i = 1; i < largestWordSize + 1; i++) {
-                printf("%6d", i);
-            }
-            printf("\n   ");
-            for (i = 1; i < largestWordSize + 1; i++) {
-                printf("%6d", wordCount[i]);
-            }
-            printf("\n   ");
-            for (i = 1; i < largestWordSize + 1; i++) {
-                printf("%6.2f", ((float)wordCount[i] * 100.0) /
-                                    (float)totalNumberOfWords);
-            }
-            for (i = 0; i < largestWordSize + 1; i++) {
-                printf("\n%2d ", i);
-                for (int j = 1; j < i; j++) {
-                    printf("%6s", " ");
-                }
-                if (i == 0) {
-                    for (int j = 1; j < largestWordSize + 1; j++) {
-                        if (wordCount[j] > 0) {
-                            printf("%6.1f", (vowelsCount[i][j] * 100.0) /
-                                                (float)wordCount[j]);
-                        } else {
-                            printf("%6.1f", 0.0);
-                        }
-                    }
-                } else {
-                    for (int j = i; j < largestWordSize + 1; j++) {
-                        if (wordCount[j] > 0) {
-                            printf("%6.1f", (vowelsCount[i][j] * 100.0) /
-                                                (float)wordCount[j]);
-                        } else {
-                            printf("%6.1f", 0.0);
-                        }
-                    }
-                }
-            }
-            printf("\n\n");
+            // Write the results of the file, final at once
+            addHistogram(&results, fileIndex - optind, &hist);
+            writeFileResults(&writer, &results, fileIndex - optind,
+                             argv[fileIndex]);
+            freeHistogram(&hist);
         }
         fclose(file);
     }
+    if (!closeResultWriter(&writer)) {
+        perror("Error while writing the results.\n");
+        exit(EXIT_FAILURE);
+    }
+    freeResults(&results);
 
     return (0);
 }
\ No newline at end of file